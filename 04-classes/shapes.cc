@@ -1,82 +1,15 @@
 // Polymorphic hierarchy with pure virtual base class, container of unique_ptr to base class.
 #include <cmath>
 #include <memory>
+#include <random>
 #include <typeinfo>
 #include <vector>
 
+#include "shapes.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-class Shape
-{
-public:
-    virtual ~Shape() {} // Abstract classes require virtual destructor.
-
-    // area returns area of shape.
-    virtual double area() const = 0;
-
-    // perimeter returns perimeter of shape.
-    virtual double perimeter() const = 0;
-
-protected:
-    static constexpr double pi = 2.*std::acos(0.);
-};
-
-class Square : public Shape
-{
-public:
-    Square() {}
-
-    Square(double s)
-        : side(s)
-    {}
-
-    double area() const override
-    {
-        return side*side;
-    }
-
-    double perimeter() const override
-    {
-        return 4*side;
-    }
-
-private:
-    double side = 0.; // Default value.
-};
-
-class Circle : public Shape
-{
-public:
-    Circle() {}
-
-    Circle(double r)
-        : radius(r)
-    { }
-
-    double area() const override
-    {
-        return pi*radius*radius;
-    }
-
-    double perimeter() const override
-    {
-        return 2.*pi*radius;
-    }
-
-private:
-    double radius = 0.; // Default value.
-};
-
-double sum_area(const std::vector<std::unique_ptr<Shape>>& shapes)
-{
-    double sum = 0.;
-    for (const auto& s : shapes) { // Use const reference to avoid transfer of ownership.
-        sum += s->area();
-    }
-    return sum;
-}
-
 TEST_CASE("[Shape]")
 {
     Square sq(2.);
@@ -111,3 +44,42 @@ TEST_CASE("[dynamic_cast]")
     REQUIRE_THROWS_AS(dynamic_cast<Circle&>(rs), std::bad_cast);
     REQUIRE_NOTHROW(dynamic_cast<Square&>(rs));
 }
+
+TEST_CASE("[ShapeStore]")
+{
+    ShapeStore store;
+    REQUIRE(store.total_area() == 0.);
+    REQUIRE(store.total_perimeter() == 0.);
+
+    store.add_square(2.);
+    store.add_circle(1.);
+    REQUIRE(store.size() == 2);
+    REQUIRE(store.total_area() == 4. + M_PI);
+    REQUIRE(store.total_perimeter() == 8. + 2.*M_PI);
+
+    // Compare to the sums over the polymorphic container.
+    std::vector<std::unique_ptr<Shape>> shapes;
+    shapes.emplace_back(std::make_unique<Square>(2.));
+    shapes.emplace_back(std::make_unique<Circle>(1.));
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 10.};
+    for (int i = 0; i != 1001; ++i) {
+        double d = dist(gen);
+        if (i % 3 == 0) {
+            store.add_square(d);
+            shapes.emplace_back(std::make_unique<Square>(d));
+        }
+        else {
+            store.add_circle(d);
+            shapes.emplace_back(std::make_unique<Circle>(d));
+        }
+    }
+    REQUIRE(store.num_squares() == 335);
+    REQUIRE(store.num_circles() == 668);
+    double perimeter = 0.;
+    for (const auto& s : shapes) {
+        perimeter += s->perimeter();
+    }
+    REQUIRE(std::abs(store.total_area() - sum_area(shapes)) < 1e-9 * sum_area(shapes));
+    REQUIRE(std::abs(store.total_perimeter() - perimeter) < 1e-9 * perimeter);
+}
@@ -0,0 +1,162 @@
+// Polymorphic hierarchy with pure virtual base class, and a store of shapes by type.
+//
+// A container of unique_ptr to Shape allocates each shape on its own, and
+// calls area through a pointer to a function that depends on the shape, so a
+// sum over many shapes misses the cache and mispredicts calls in turn.
+// ShapeStore instead keeps the dimension of the shapes of each type in its
+// own array, e.g. the sides of all the squares, and computes the area of
+// each type by the static area of the type in a loop over its array that the
+// compiler vectorizes. The order of the shapes is not kept.
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../06-templates/accumulate.h"
+
+class Shape
+{
+public:
+    virtual ~Shape() {} // Abstract classes require virtual destructor.
+
+    // area returns area of shape.
+    virtual double area() const = 0;
+
+    // perimeter returns perimeter of shape.
+    virtual double perimeter() const = 0;
+
+protected:
+    static constexpr double pi = 2.*std::acos(0.);
+};
+
+class Square : public Shape
+{
+public:
+    Square() {}
+
+    Square(double s)
+        : side(s)
+    {}
+
+    double area() const override
+    {
+        return area(side);
+    }
+
+    double perimeter() const override
+    {
+        return perimeter(side);
+    }
+
+    // area returns area of square with side s.
+    static constexpr double area(double s)
+    {
+        return s*s;
+    }
+
+    // perimeter returns perimeter of square with side s.
+    static constexpr double perimeter(double s)
+    {
+        return 4*s;
+    }
+
+private:
+    double side = 0.; // Default value.
+};
+
+class Circle : public Shape
+{
+public:
+    Circle() {}
+
+    Circle(double r)
+        : radius(r)
+    { }
+
+    double area() const override
+    {
+        return area(radius);
+    }
+
+    double perimeter() const override
+    {
+        return perimeter(radius);
+    }
+
+    // area returns area of circle with radius r.
+    static constexpr double area(double r)
+    {
+        return pi*r*r;
+    }
+
+    // perimeter returns perimeter of circle with radius r.
+    static constexpr double perimeter(double r)
+    {
+        return 2.*pi*r;
+    }
+
+private:
+    double radius = 0.; // Default value.
+};
+
+inline double sum_area(const std::vector<std::unique_ptr<Shape>>& shapes)
+{
+    double sum = 0.;
+    for (const auto& s : shapes) { // Use const reference to avoid transfer of ownership.
+        sum += s->area();
+    }
+    return sum;
+}
+
+// ShapeStore keeps squares and circles as arrays of their sides and radii.
+class ShapeStore
+{
+public:
+    void add_square(double side)
+    {
+        sides.push_back(side);
+    }
+
+    void add_circle(double radius)
+    {
+        radii.push_back(radius);
+    }
+
+    void reserve(std::size_t num_squares, std::size_t num_circles)
+    {
+        sides.reserve(num_squares);
+        radii.reserve(num_circles);
+    }
+
+    std::size_t size() const { return sides.size() + radii.size(); }
+    std::size_t num_squares() const { return sides.size(); }
+    std::size_t num_circles() const { return radii.size(); }
+
+    // total_area returns the sum of the areas of all shapes.
+    double total_area() const
+    {
+        return sum(sides, [](double s) { return Square::area(s); }) +
+               sum(radii, [](double r) { return Circle::area(r); });
+    }
+
+    // total_perimeter returns the sum of the perimeters of all shapes.
+    double total_perimeter() const
+    {
+        return sum(sides, [](double s) { return Square::perimeter(s); }) +
+               sum(radii, [](double r) { return Circle::perimeter(r); });
+    }
+
+private:
+    // sum returns the sum of f of the elements of v, added in the
+    // independent lanes of accumulate under unseq.
+    template <typename F>
+    static double sum(const std::vector<double>& v, F f)
+    {
+        return mystd::_accumulate_unseq(v.data(), v.size(), 0., f);
+    }
+
+    std::vector<double> sides;
+    std::vector<double> radii;
+};
@@ -0,0 +1,125 @@
+// Benchmark total area and perimeter of shapes by virtual call, variant and ShapeStore.
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+#include "shapes.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Shapes holds the same random squares and circles in each container.
+struct Shapes
+{
+    std::vector<std::unique_ptr<Shape>> pointers; // In allocation order.
+    std::vector<const Shape*> shuffled;
+    std::vector<std::variant<Square, Circle>> variants;
+    ShapeStore store;
+};
+
+// make_shapes returns n shapes, a third of them squares in random order. The
+// shuffled pointers are in random order after allocation, as when shapes are
+// added and removed over time, so that they do not follow each other in
+// memory.
+Shapes make_shapes(std::size_t n)
+{
+    Shapes s;
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 10.};
+    std::bernoulli_distribution is_square{1. / 3};
+    s.pointers.reserve(n);
+    s.shuffled.reserve(n);
+    s.variants.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        double d = dist(gen);
+        if (is_square(gen)) {
+            s.pointers.emplace_back(std::make_unique<Square>(d));
+            s.variants.emplace_back(Square(d));
+            s.store.add_square(d);
+        }
+        else {
+            s.pointers.emplace_back(std::make_unique<Circle>(d));
+            s.variants.emplace_back(Circle(d));
+            s.store.add_circle(d);
+        }
+    }
+    for (const auto& p : s.pointers) {
+        s.shuffled.push_back(p.get());
+    }
+    std::shuffle(s.shuffled.begin(), s.shuffled.end(), gen);
+    return s;
+}
+
+template <typename Total>
+void bench_total(timeit::State& state, Total total)
+{
+    auto s = make_shapes(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(total(s));
+    }
+    state.set_items_processed(s.store.size());
+}
+
+#define SHAPE_SIZES 1'000, 100'000, 10'000'000
+
+TIMEIT_BENCHMARK_ARGS("[total_area:virtual]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) {
+        double sum = 0.;
+        for (const auto* p : s.shuffled) {
+            sum += p->area();
+        }
+        return sum;
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_area:virtual:unshuffled]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) { return sum_area(s.pointers); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_area:variant]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) {
+        double sum = 0.;
+        for (const auto& v : s.variants) {
+            sum += std::visit([](const auto& shape) { return shape.area(); }, v);
+        }
+        return sum;
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_area:ShapeStore]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) { return s.store.total_area(); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_perimeter:virtual]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) {
+        double sum = 0.;
+        for (const auto* p : s.shuffled) {
+            sum += p->perimeter();
+        }
+        return sum;
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_perimeter:virtual:unshuffled]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) {
+        double sum = 0.;
+        for (const auto& p : s.pointers) {
+            sum += p->perimeter();
+        }
+        return sum;
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[total_perimeter:ShapeStore]", SHAPE_SIZES)
+{
+    bench_total(state, [](const Shapes& s) { return s.store.total_perimeter(); });
+}
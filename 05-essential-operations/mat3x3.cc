@@ -1,123 +1,20 @@
 // Demonstrate copy/move constructor and assignment for POD-type class.
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <istream>
 #include <ostream>
+#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <utility>
+#include <vector>
+
+#include "mat3x3.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Mat3x3 demonstrates all essential operations for a POD-type.
-// Many of these operations could be implicitly compiler generated,
-// but aren't in order to demonstrate semantics.
-class Mat3x3
-{
-public:
-    // Default constructor, compiler generated.
-    Mat3x3() = default;
-
-    // Ordinary constructor.
-    explicit Mat3x3(double m0)
-    {
-        std::fill(&m[i0], &m[iN], m0);
-    }
-
-    // Copy constructor.
-    Mat3x3(const Mat3x3& rhs)
-    {
-        std::copy(&rhs.m[i0], &rhs.m[iN], &m[i0]);
-    }
-
-    // Move constructor.
-    Mat3x3(Mat3x3&& rhs)
-    {
-        std::swap(m, rhs.m); // Move implemented through std::swap.
-    }
-
-    // Copy-assignment.
-    Mat3x3& operator=(const Mat3x3& rhs)
-    {
-        std::copy(&rhs.m[i0], &rhs.m[iN], &m[i0]);
-        return *this;
-    }
-
-    // Move-assignment.
-    Mat3x3& operator=(Mat3x3&& rhs)
-    {
-        std::swap(m, rhs.m); // Move implemented through std::swap.
-        return *this;
-    }
-
-    // Destructor, compiler generated.
-    ~Mat3x3() = default;
-
-    // Non-const access to elements of matrix through double index.
-    double& operator()(std::size_t i, std::size_t j)
-    {
-        return m[i*D+j];
-    }
-
-    // Const access to elements of matrix through double index.
-    const double& operator()(std::size_t i, std::size_t j) const
-    {
-        return m[i*D+j];
-    }
-
-    // Overloaded output operator.
-    friend std::ostream& operator<<(std::ostream& os, const Mat3x3& m);
-
-    // Overloaded input operator.
-    friend std::istream& operator>>(std::istream& is, Mat3x3& m);
-
-private:
-    double m[9] = {0.};
-
-    // Index of first and last element in matrix.
-    static constexpr std::size_t i0 = 0;
-    static constexpr std::size_t iN = 9;
-
-    // Index of dimension of matrix.
-    static constexpr std::size_t D = 3;
-};
-
-// Overloaded output operator.
-std::ostream& operator<<(std::ostream& os, const Mat3x3& m)
-{
-    os << "[";
-    for (std::size_t i = 0; i != 3; ++i) {
-        os << "[";
-        for (std::size_t j = 0; j != 3; ++j) {
-            os << m(i,j) << (j != 2 ? "," : "");
-        }
-        os << "]" << (i !=2 ? "," : "");
-    }
-    os << "]";
-    return os;
-}
-
-// Overloaded input operator.
-std::istream& operator>>(std::istream& is, Mat3x3& m)
-{
-    char c;
-    is>>c; // Discard: [
-    for (std::size_t i = 0; i != 3; ++i) {
-        is>>c; // Discard: [
-        for (std::size_t j = 0; j != 3; ++j) {
-            is>>m(i,j);
-            if (j != 2) {
-                is>>c; // Discard: ,
-            }
-        }
-        is>>c; // Discard: ]
-        if (i != 2) {
-            is>>c; // Discard: ,
-        }
-    }
-    return is;
-}
-
 TEST_CASE("[Mat3x3]")
 {
     Mat3x3 m1;
@@ -218,3 +115,93 @@ TEST_CASE("[Mat3x3::operator>>]")
         }
     }
 }
+
+TEST_CASE("[Mat3x3:arithmetic]")
+{
+    Mat3x3 m1, m2;
+    std::istringstream{"[[2,0,0],[0,3,0],[0,0,4]]"} >> m1;
+    std::istringstream{"[[1,2,3],[0,1,4],[5,6,0]]"} >> m2;
+
+    SUBCASE("Multiply")
+    {
+        std::ostringstream oss;
+        oss << m1 * m2;
+        REQUIRE(oss.str() == "[[2,4,6],[0,3,12],[20,24,0]]");
+        REQUIRE(m2 * Vec3{1, 1, 1} == Vec3{6, 5, 11});
+    }
+
+    SUBCASE("Transpose")
+    {
+        std::ostringstream oss;
+        oss << transpose(m2);
+        REQUIRE(oss.str() == "[[1,0,5],[2,1,6],[3,4,0]]");
+    }
+
+    SUBCASE("Determinant and inverse")
+    {
+        REQUIRE(determinant(m1) == 24.);
+        REQUIRE(determinant(m2) == 1.);
+
+        std::ostringstream oss;
+        oss << inverse(m2);
+        REQUIRE(oss.str() == "[[-24,18,5],[20,-15,-4],[-5,4,1]]");
+        REQUIRE_THROWS_AS(inverse(Mat3x3{1.}), std::domain_error);
+    }
+}
+
+TEST_CASE("[Mat3x3Batch]")
+{
+    // Sizes that do and do not fill the last pack.
+    for (std::size_t n : {1, 7, 8, 9, 33}) {
+        std::default_random_engine gen{};
+        std::uniform_real_distribution<double> dist{-1., 1.};
+        std::vector<Mat3x3> ma(n), mb(n);
+        std::vector<Vec3> vs(n);
+        Mat3x3Batch a(n), b(n);
+        Vec3Batch v(n);
+        for (std::size_t i = 0; i != n; ++i) {
+            for (std::size_t k = 0; k != 9; ++k) {
+                ma[i].data()[k] = dist(gen);
+                mb[i].data()[k] = dist(gen);
+            }
+            vs[i] = {dist(gen), dist(gen), dist(gen)};
+            a.set(i, ma[i]);
+            b.set(i, mb[i]);
+            v.set(i, vs[i]);
+        }
+
+        // Batch kernels agree with the matrices one at a time.
+        auto equal = [](const Mat3x3& m1, const Mat3x3& m2) {
+            return std::equal(m1.data(), m1.data() + 9, m2.data(),
+                [](double x, double y) { return std::abs(x - y) < 1e-9 * (1 + std::abs(x)); });
+        };
+        Mat3x3Batch c, t, inv;
+        Vec3Batch out;
+        std::vector<double> det;
+        multiply(a, b, c);
+        transpose(a, t);
+        inverse(a, inv);
+        transform(a, v, out);
+        determinant(a, det);
+        REQUIRE(c.size() == n);
+        REQUIRE(det.size() == n);
+        for (std::size_t i = 0; i != n; ++i) {
+            REQUIRE(equal(c.get(i), ma[i] * mb[i]));
+            REQUIRE(equal(t.get(i), transpose(ma[i])));
+            REQUIRE(equal(inv.get(i), inverse(ma[i])));
+            auto expected = ma[i] * vs[i];
+            for (std::size_t k = 0; k != 3; ++k) {
+                REQUIRE(std::abs(out.get(i)[k] - expected[k]) < 1e-9);
+            }
+            REQUIRE(std::abs(det[i] - determinant(ma[i])) < 1e-9);
+        }
+
+        // Growing a batch adds zero matrices.
+        inv.resize(n + 1);
+        REQUIRE(equal(inv.get(n), Mat3x3{}));
+    }
+
+    Mat3x3Batch a(2);
+    Vec3Batch v(3), out;
+    REQUIRE_THROWS_AS(transform(a, v, out), std::invalid_argument);
+}
@@ -0,0 +1,489 @@
+// 3x3 matrices of doubles, one at a time and in batches for SIMD.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Mat3x3 demonstrates all essential operations for a POD-type.
+// Many of these operations could be implicitly compiler generated,
+// but aren't in order to demonstrate semantics.
+class Mat3x3
+{
+public:
+    // Default constructor, compiler generated.
+    Mat3x3() = default;
+
+    // Ordinary constructor.
+    explicit Mat3x3(double m0)
+    {
+        std::fill(&m[i0], &m[iN], m0);
+    }
+
+    // Copy constructor.
+    Mat3x3(const Mat3x3& rhs)
+    {
+        std::copy(&rhs.m[i0], &rhs.m[iN], &m[i0]);
+    }
+
+    // Move constructor.
+    Mat3x3(Mat3x3&& rhs)
+    {
+        std::swap(m, rhs.m); // Move implemented through std::swap.
+    }
+
+    // Copy-assignment.
+    Mat3x3& operator=(const Mat3x3& rhs)
+    {
+        std::copy(&rhs.m[i0], &rhs.m[iN], &m[i0]);
+        return *this;
+    }
+
+    // Move-assignment.
+    Mat3x3& operator=(Mat3x3&& rhs)
+    {
+        std::swap(m, rhs.m); // Move implemented through std::swap.
+        return *this;
+    }
+
+    // Destructor, compiler generated.
+    ~Mat3x3() = default;
+
+    // Non-const access to elements of matrix through double index.
+    double& operator()(std::size_t i, std::size_t j)
+    {
+        return m[i*D+j];
+    }
+
+    // Const access to elements of matrix through double index.
+    const double& operator()(std::size_t i, std::size_t j) const
+    {
+        return m[i*D+j];
+    }
+
+    // Access to the 9 elements of the matrix in row-major order.
+    double* data() { return m; }
+    const double* data() const { return m; }
+
+    // Overloaded output operator.
+    friend std::ostream& operator<<(std::ostream& os, const Mat3x3& m);
+
+    // Overloaded input operator.
+    friend std::istream& operator>>(std::istream& is, Mat3x3& m);
+
+private:
+    double m[9] = {0.};
+
+    // Index of first and last element in matrix.
+    static constexpr std::size_t i0 = 0;
+    static constexpr std::size_t iN = 9;
+
+    // Index of dimension of matrix.
+    static constexpr std::size_t D = 3;
+};
+
+// Overloaded output operator.
+inline std::ostream& operator<<(std::ostream& os, const Mat3x3& m)
+{
+    os << "[";
+    for (std::size_t i = 0; i != 3; ++i) {
+        os << "[";
+        for (std::size_t j = 0; j != 3; ++j) {
+            os << m(i,j) << (j != 2 ? "," : "");
+        }
+        os << "]" << (i !=2 ? "," : "");
+    }
+    os << "]";
+    return os;
+}
+
+// Overloaded input operator.
+inline std::istream& operator>>(std::istream& is, Mat3x3& m)
+{
+    char c;
+    is>>c; // Discard: [
+    for (std::size_t i = 0; i != 3; ++i) {
+        is>>c; // Discard: [
+        for (std::size_t j = 0; j != 3; ++j) {
+            is>>m(i,j);
+            if (j != 2) {
+                is>>c; // Discard: ,
+            }
+        }
+        is>>c; // Discard: ]
+        if (i != 2) {
+            is>>c; // Discard: ,
+        }
+    }
+    return is;
+}
+
+using Vec3 = std::array<double, 3>;
+
+// The arithmetic below is written once over V, either double for a single
+// matrix or _Pack for the same element of several matrices of a batch. The
+// elements of a matrix are a[0] to a[8] in row-major order.
+
+template <typename V>
+inline void _multiply(const V* a, const V* b, V* c)
+{
+    for (std::size_t i = 0; i != 3; ++i) {
+        for (std::size_t j = 0; j != 3; ++j) {
+            c[i*3+j] = a[i*3]*b[j] + a[i*3+1]*b[3+j] + a[i*3+2]*b[6+j];
+        }
+    }
+}
+
+template <typename V>
+inline void _transpose(const V* a, V* t)
+{
+    for (std::size_t i = 0; i != 3; ++i) {
+        for (std::size_t j = 0; j != 3; ++j) {
+            t[j*3+i] = a[i*3+j];
+        }
+    }
+}
+
+template <typename V>
+inline V _determinant(const V* a)
+{
+    return a[0]*(a[4]*a[8] - a[5]*a[7]) -
+           a[1]*(a[3]*a[8] - a[5]*a[6]) +
+           a[2]*(a[3]*a[7] - a[4]*a[6]);
+}
+
+// _inverse is the adjugate divided by the determinant det of a.
+template <typename V>
+inline void _inverse(const V* a, V det, V* inv)
+{
+    V r = V(1.) / det;
+    inv[0] = (a[4]*a[8] - a[5]*a[7]) * r;
+    inv[1] = (a[2]*a[7] - a[1]*a[8]) * r;
+    inv[2] = (a[1]*a[5] - a[2]*a[4]) * r;
+    inv[3] = (a[5]*a[6] - a[3]*a[8]) * r;
+    inv[4] = (a[0]*a[8] - a[2]*a[6]) * r;
+    inv[5] = (a[2]*a[3] - a[0]*a[5]) * r;
+    inv[6] = (a[3]*a[7] - a[4]*a[6]) * r;
+    inv[7] = (a[1]*a[6] - a[0]*a[7]) * r;
+    inv[8] = (a[0]*a[4] - a[1]*a[3]) * r;
+}
+
+template <typename V>
+inline void _transform(const V* a, const V* v, V* out)
+{
+    for (std::size_t i = 0; i != 3; ++i) {
+        out[i] = a[i*3]*v[0] + a[i*3+1]*v[1] + a[i*3+2]*v[2];
+    }
+}
+
+inline Mat3x3 operator*(const Mat3x3& a, const Mat3x3& b)
+{
+    Mat3x3 c;
+    _multiply(a.data(), b.data(), c.data());
+    return c;
+}
+
+inline Vec3 operator*(const Mat3x3& a, const Vec3& v)
+{
+    Vec3 out;
+    _transform(a.data(), v.data(), out.data());
+    return out;
+}
+
+inline Mat3x3 transpose(const Mat3x3& a)
+{
+    Mat3x3 t;
+    _transpose(a.data(), t.data());
+    return t;
+}
+
+inline double determinant(const Mat3x3& a)
+{
+    return _determinant(a.data());
+}
+
+// inverse returns the inverse of a, std::domain_error if a is singular.
+inline Mat3x3 inverse(const Mat3x3& a)
+{
+    double det = determinant(a);
+    if (det == 0.) {
+        throw std::domain_error{"inverse: singular matrix"};
+    }
+    Mat3x3 inv;
+    _inverse(a.data(), det, inv.data());
+    return inv;
+}
+
+// _Pack is the widest vector of doubles of the target, one lane per matrix.
+#if defined(__AVX512F__)
+struct _Pack
+{
+    static constexpr std::size_t width = 8;
+
+    _Pack() = default;
+    _Pack(double x) : v{_mm512_set1_pd(x)} {}
+    _Pack(__m512d v) : v{v} {}
+
+    static _Pack load(const double* p) { return _mm512_loadu_pd(p); }
+    void store(double* p) const { _mm512_storeu_pd(p, v); }
+
+    friend _Pack operator+(_Pack a, _Pack b) { return _mm512_add_pd(a.v, b.v); }
+    friend _Pack operator-(_Pack a, _Pack b) { return _mm512_sub_pd(a.v, b.v); }
+    friend _Pack operator*(_Pack a, _Pack b) { return _mm512_mul_pd(a.v, b.v); }
+    friend _Pack operator/(_Pack a, _Pack b) { return _mm512_div_pd(a.v, b.v); }
+
+    __m512d v;
+};
+#elif defined(__AVX2__)
+struct _Pack
+{
+    static constexpr std::size_t width = 4;
+
+    _Pack() = default;
+    _Pack(double x) : v{_mm256_set1_pd(x)} {}
+    _Pack(__m256d v) : v{v} {}
+
+    static _Pack load(const double* p) { return _mm256_loadu_pd(p); }
+    void store(double* p) const { _mm256_storeu_pd(p, v); }
+
+    friend _Pack operator+(_Pack a, _Pack b) { return _mm256_add_pd(a.v, b.v); }
+    friend _Pack operator-(_Pack a, _Pack b) { return _mm256_sub_pd(a.v, b.v); }
+    friend _Pack operator*(_Pack a, _Pack b) { return _mm256_mul_pd(a.v, b.v); }
+    friend _Pack operator/(_Pack a, _Pack b) { return _mm256_div_pd(a.v, b.v); }
+
+    __m256d v;
+};
+#else
+struct _Pack
+{
+    static constexpr std::size_t width = 1;
+
+    _Pack() = default;
+    _Pack(double x) : v{x} {}
+
+    static _Pack load(const double* p) { return *p; }
+    void store(double* p) const { *p = v; }
+
+    friend _Pack operator+(_Pack a, _Pack b) { return a.v + b.v; }
+    friend _Pack operator-(_Pack a, _Pack b) { return a.v - b.v; }
+    friend _Pack operator*(_Pack a, _Pack b) { return a.v * b.v; }
+    friend _Pack operator/(_Pack a, _Pack b) { return a.v / b.v; }
+
+    double v;
+};
+#endif
+
+// _SoABatch stores the K elements of many objects as K arrays, each padded
+// to a multiple of the width of _Pack so kernels need no scalar remainder.
+template <std::size_t K>
+class _SoABatch
+{
+public:
+    explicit _SoABatch(std::size_t n = 0)
+    {
+        resize(n);
+    }
+
+    std::size_t size() const { return n; }
+
+    // resize to n objects, new ones are zero.
+    void resize(std::size_t n)
+    {
+        if (n == this->n) {
+            return;
+        }
+        std::size_t padded = (n + _Pack::width - 1) / _Pack::width * _Pack::width;
+        for (auto& e : elems) {
+            // Kernels write the padding, so zero all but the old objects.
+            e.resize(std::min(n, this->n));
+            e.resize(padded);
+        }
+        this->n = n;
+    }
+
+    // data returns the array of element k of all objects.
+    double* data(std::size_t k) { return elems[k].data(); }
+    const double* data(std::size_t k) const { return elems[k].data(); }
+
+private:
+    std::array<std::vector<double>, K> elems;
+    std::size_t n = 0;
+};
+
+// Mat3x3Batch is a structure of arrays of 3x3 matrices: element (i,j) of all
+// matrices is contiguous, so a vector register holds it for several matrices.
+class Mat3x3Batch : public _SoABatch<9>
+{
+public:
+    using _SoABatch::_SoABatch;
+
+    Mat3x3 get(std::size_t b) const
+    {
+        Mat3x3 m;
+        for (std::size_t k = 0; k != 9; ++k) {
+            m.data()[k] = data(k)[b];
+        }
+        return m;
+    }
+
+    void set(std::size_t b, const Mat3x3& m)
+    {
+        for (std::size_t k = 0; k != 9; ++k) {
+            data(k)[b] = m.data()[k];
+        }
+    }
+};
+
+// Vec3Batch is a structure of arrays of 3-vectors.
+class Vec3Batch : public _SoABatch<3>
+{
+public:
+    using _SoABatch::_SoABatch;
+
+    Vec3 get(std::size_t b) const
+    {
+        return {data(0)[b], data(1)[b], data(2)[b]};
+    }
+
+    void set(std::size_t b, const Vec3& v)
+    {
+        for (std::size_t k = 0; k != 3; ++k) {
+            data(k)[b] = v[k];
+        }
+    }
+};
+
+// _columns returns the arrays of the K elements of the objects of batch,
+// hoisted out of the kernel loops since stores could alias them otherwise.
+template <std::size_t K, typename Batch>
+inline std::array<const double*, K> _columns(const Batch& batch)
+{
+    std::array<const double*, K> p;
+    for (std::size_t k = 0; k != K; ++k) {
+        p[k] = batch.data(k);
+    }
+    return p;
+}
+
+template <std::size_t K, typename Batch>
+inline std::array<double*, K> _columns(Batch& batch)
+{
+    std::array<double*, K> p;
+    for (std::size_t k = 0; k != K; ++k) {
+        p[k] = batch.data(k);
+    }
+    return p;
+}
+
+// _load loads the K elements of the objects at offset i.
+template <std::size_t K>
+inline std::array<_Pack, K> _load(const std::array<const double*, K>& p, std::size_t i)
+{
+    std::array<_Pack, K> v;
+    for (std::size_t k = 0; k != K; ++k) {
+        v[k] = _Pack::load(p[k] + i);
+    }
+    return v;
+}
+
+template <std::size_t K>
+inline void _store(const std::array<_Pack, K>& v, const std::array<double*, K>& p, std::size_t i)
+{
+    for (std::size_t k = 0; k != K; ++k) {
+        v[k].store(p[k] + i);
+    }
+}
+
+template <typename Batch1, typename Batch2>
+inline void _check_sizes(const Batch1& a, const Batch2& b)
+{
+    if (a.size() != b.size()) {
+        throw std::invalid_argument{"Mat3x3Batch: sizes differ"};
+    }
+}
+
+// multiply sets c to the products of the matrices of a and b.
+inline void multiply(const Mat3x3Batch& a, const Mat3x3Batch& b, Mat3x3Batch& c)
+{
+    _check_sizes(a, b);
+    c.resize(a.size());
+    auto pa = _columns<9>(a), pb = _columns<9>(b);
+    auto pc = _columns<9>(c);
+    for (std::size_t i = 0; i < a.size(); i += _Pack::width) {
+        auto va = _load(pa, i), vb = _load(pb, i);
+        std::array<_Pack, 9> vc;
+        _multiply(va.data(), vb.data(), vc.data());
+        _store(vc, pc, i);
+    }
+}
+
+// transform sets out to the products of the matrices of a and vectors of v.
+inline void transform(const Mat3x3Batch& a, const Vec3Batch& v, Vec3Batch& out)
+{
+    _check_sizes(a, v);
+    out.resize(a.size());
+    auto pa = _columns<9>(a);
+    auto pv = _columns<3>(v);
+    auto pout = _columns<3>(out);
+    for (std::size_t i = 0; i < a.size(); i += _Pack::width) {
+        auto va = _load(pa, i);
+        auto vv = _load(pv, i);
+        std::array<_Pack, 3> vout;
+        _transform(va.data(), vv.data(), vout.data());
+        _store(vout, pout, i);
+    }
+}
+
+inline void transpose(const Mat3x3Batch& a, Mat3x3Batch& t)
+{
+    t.resize(a.size());
+    auto pa = _columns<9>(a);
+    auto pt = _columns<9>(t);
+    for (std::size_t i = 0; i < a.size(); i += _Pack::width) {
+        auto va = _load(pa, i);
+        std::array<_Pack, 9> vt;
+        _transpose(va.data(), vt.data());
+        _store(vt, pt, i);
+    }
+}
+
+// determinant sets det to the determinants of the matrices of a.
+inline void determinant(const Mat3x3Batch& a, std::vector<double>& det)
+{
+    det.resize(a.size());
+    auto pa = _columns<9>(a);
+    std::size_t i = 0;
+    for (; i + _Pack::width <= a.size(); i += _Pack::width) {
+        _determinant(_load(pa, i).data()).store(det.data() + i);
+    }
+    if (i != a.size()) {
+        // det is not padded.
+        double tail[_Pack::width];
+        _determinant(_load(pa, i).data()).store(tail);
+        std::copy(tail, tail + (a.size() - i), det.data() + i);
+    }
+}
+
+// inverse sets inv to the inverses of the matrices of a. Unlike inverse of
+// Mat3x3, a singular matrix does not throw, its inverse is not finite.
+inline void inverse(const Mat3x3Batch& a, Mat3x3Batch& inv)
+{
+    inv.resize(a.size());
+    auto pa = _columns<9>(a);
+    auto pinv = _columns<9>(inv);
+    for (std::size_t i = 0; i < a.size(); i += _Pack::width) {
+        auto va = _load(pa, i);
+        std::array<_Pack, 9> vinv;
+        _inverse(va.data(), _determinant(va.data()), vinv.data());
+        _store(vinv, pinv, i);
+    }
+}
@@ -0,0 +1,111 @@
+// Benchmark an array of Mat3x3 against Mat3x3Batch.
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "mat3x3.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_matrices returns n random matrices, well conditioned for inverse.
+std::vector<Mat3x3> make_matrices(std::size_t n)
+{
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{-1., 1.};
+    std::vector<Mat3x3> ms(n);
+    for (auto& m : ms) {
+        for (std::size_t i = 0; i != 3; ++i) {
+            for (std::size_t j = 0; j != 3; ++j) {
+                m(i,j) = dist(gen) + (i == j ? 4. : 0.);
+            }
+        }
+    }
+    return ms;
+}
+
+Mat3x3Batch make_batch(const std::vector<Mat3x3>& ms)
+{
+    Mat3x3Batch batch(ms.size());
+    for (std::size_t i = 0; i != ms.size(); ++i) {
+        batch.set(i, ms[i]);
+    }
+    return batch;
+}
+
+#define BATCH_SIZES 100, 10'000, 1'000'000
+
+TIMEIT_BENCHMARK_ARGS("[multiply:Mat3x3]", BATCH_SIZES)
+{
+    auto a = make_matrices(state.arg()), b = make_matrices(state.arg());
+    std::vector<Mat3x3> c(a.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i != a.size(); ++i) {
+            c[i] = a[i] * b[i];
+        }
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[multiply:Mat3x3Batch]", BATCH_SIZES)
+{
+    auto a = make_batch(make_matrices(state.arg())), b = make_batch(make_matrices(state.arg()));
+    Mat3x3Batch c(a.size());
+    while (state.keep_running()) {
+        multiply(a, b, c);
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[transform:Mat3x3]", BATCH_SIZES)
+{
+    auto a = make_matrices(state.arg());
+    std::vector<Vec3> v(a.size(), Vec3{1., 2., 3.}), out(a.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i != a.size(); ++i) {
+            out[i] = a[i] * v[i];
+        }
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[transform:Mat3x3Batch]", BATCH_SIZES)
+{
+    auto a = make_batch(make_matrices(state.arg()));
+    Vec3Batch v(a.size()), out(a.size());
+    for (std::size_t i = 0; i != a.size(); ++i) {
+        v.set(i, {1., 2., 3.});
+    }
+    while (state.keep_running()) {
+        transform(a, v, out);
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[inverse:Mat3x3]", BATCH_SIZES)
+{
+    auto a = make_matrices(state.arg());
+    std::vector<Mat3x3> inv(a.size());
+    while (state.keep_running()) {
+        for (std::size_t i = 0; i != a.size(); ++i) {
+            inv[i] = inverse(a[i]);
+        }
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[inverse:Mat3x3Batch]", BATCH_SIZES)
+{
+    auto a = make_batch(make_matrices(state.arg()));
+    Mat3x3Batch inv(a.size());
+    while (state.keep_running()) {
+        inverse(a, inv);
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(a.size());
+}
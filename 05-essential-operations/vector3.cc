@@ -2,117 +2,17 @@
 #include <algorithm>
 #include <cstddef>
 #include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+#include "vector3.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Vector demonstrates all the essential operations for a resource handle.
-// Unlike POD-types, resource handles require non-default implementations.
-template <typename T>
-class Vector
-{
-public:
-    // Default constructor.
-    Vector() = default;
-
-    // Ordinary constructor.
-    explicit Vector(std::size_t sz)
-        : elems(new T[sz])
-        , sz(sz)
-    {}
-
-    // Copy constructor.
-    Vector(const Vector<T>& rhs)
-        : elems(new T[rhs.sz])
-        , sz(rhs.sz)
-    {
-        std::copy(cbegin(rhs), cend(rhs), begin(*this));
-    }
-
-    // Move constructor.
-    Vector(Vector<T>&& rhs)
-    {
-        std::swap(elems, rhs.elems);
-        std::swap(sz, rhs.sz);
-    }
-
-    // Copy-assignment.
-    Vector& operator=(const Vector<T>& rhs)
-    {
-        Vector tmp(rhs); // Create a defensive copy in case of throw.
-        std::swap(elems, tmp.elems);
-        std::swap(sz, tmp.sz);
-        return *this;
-    }
-
-    // Move-assignment.
-    Vector& operator=(Vector<T>&& rhs)
-    {
-        std::swap(elems, rhs.elems);
-        std::swap(sz, rhs.sz);
-        return *this;
-    }
-
-    // Destructor.
-    ~Vector()
-    {
-        delete []elems;
-        sz = 0;
-    }
-
-    // Non-const access to elements of Vector.
-    T& operator[](std::size_t i)
-    {
-        return elems[i];
-    }
-
-    // Const access to elements of Vector.
-    const T& operator[](std::size_t i) const
-    {
-        return elems[i];
-    }
-
-    // Size returns number of elements.
-    std::size_t size() const
-    {
-        return sz;
-    }
-
-private:
-    // Default initial value is empty Vector.
-    T *elems = nullptr;
-    std::size_t sz = 0;
-};
-
-// begin satisfies requirements for range-based for loop.
-template <typename T>
-T* begin(Vector<T>& v)
-{
-    return v.size() ? &v[0] : nullptr;
-}
-
-// end satisfies requirements for range-based for loop.
-template <typename T>
-T* end(Vector<T>& v)
-{
-    return v.size() ? &v[0]+v.size() : nullptr;
-}
-
-// cbegin satisfies requirements for range-based for loop.
-template <typename T>
-const T* cbegin(const Vector<T>& v)
-{
-    return v.size() ? &v[0] : nullptr;
-}
-
-// cend satisfies requirements for range-based for loop.
-template <typename T>
-const T* cend(const Vector<T>& v)
-{
-    return v.size() ? &v[0]+v.size() : nullptr;
-}
-
 TEST_CASE("[Vector]")
 {
     Vector<int> v1;
@@ -193,3 +93,194 @@ TEST_CASE("[Vector]")
         REQUIRE(v2.size() == 0);
     }
 }
+
+TEST_CASE("[Vector:expressions]")
+{
+    Vector<double> x(5), y(5), z(5);
+    for (std::size_t i = 0; i != x.size(); ++i) {
+        x[i] = double(i);
+        y[i] = 10.*i;
+        z[i] = 1.;
+    }
+
+    SUBCASE("Operators build expressions")
+    {
+        // No Vector is created until the expression is assigned.
+        REQUIRE_FALSE(std::is_same_v<decltype(2.*x + y), Vector<double>>);
+
+        Vector<double> r = 2.*x + y*3. - x*z;
+        REQUIRE(r.size() == 5);
+        for (std::size_t i = 0; i != r.size(); ++i) {
+            REQUIRE(r[i] == 2.*i + 30.*i - i);
+        }
+    }
+
+    SUBCASE("Assignment may refer to the target")
+    {
+        x = 2*x + y;
+        for (std::size_t i = 0; i != x.size(); ++i) {
+            REQUIRE(x[i] == 12.*i);
+        }
+
+        // Assignment of a different size reallocates.
+        Vector<double> r;
+        r = x + z;
+        REQUIRE(r.size() == 5);
+        REQUIRE(r[4] == 49.);
+    }
+
+    SUBCASE("Sizes must agree")
+    {
+        Vector<double> w(4);
+        REQUIRE_THROWS_AS(x + w, std::length_error);
+    }
+}
+
+// CountingAllocator counts the allocations of std::allocator.
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    explicit CountingAllocator(int* count)
+        : count(count)
+    {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& rhs)
+        : count(rhs.count)
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*count;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator& rhs) const { return count == rhs.count; }
+    bool operator!=(const CountingAllocator& rhs) const { return count != rhs.count; }
+
+    int* count;
+};
+
+// Counted counts the objects alive.
+struct Counted
+{
+    static inline int alive = 0;
+    explicit Counted(int x) : x(x) { ++alive; }
+    Counted(const Counted& rhs) : x(rhs.x) { ++alive; }
+    ~Counted() { --alive; }
+    int x;
+};
+
+TEST_CASE("[SmallVector]")
+{
+    int count = 0;
+    using SmallVector4 = SmallVector<std::string, 4, CountingAllocator<std::string>>;
+    SmallVector4 v1{CountingAllocator<std::string>(&count)};
+    for (int i = 0; i != 4; ++i) {
+        v1.push_back(std::to_string(i));
+    }
+
+    SUBCASE("Inline storage")
+    {
+        REQUIRE(v1.size() == 4);
+        REQUIRE(v1.is_inline());
+        REQUIRE(count == 0);
+    }
+
+    SUBCASE("Geometric growth")
+    {
+        // Growing beyond N allocates, and the element may come from v1.
+        v1.emplace_back(v1[0]);
+        REQUIRE_FALSE(v1.is_inline());
+        REQUIRE(count == 1);
+        REQUIRE(v1.capacity() == 8);
+        for (int i = 5; i != 9; ++i) {
+            v1.emplace_back(std::to_string(i));
+        }
+        REQUIRE(count == 2);
+        REQUIRE(v1.capacity() == 16);
+        REQUIRE(v1[4] == "0");
+        REQUIRE(v1.back() == "8");
+
+        v1.pop_back();
+        REQUIRE(v1.size() == 8);
+    }
+
+    SUBCASE("Range-based for loop")
+    {
+        int i = 0;
+        for (const auto& x : v1) {
+            REQUIRE(x == std::to_string(i++));
+        }
+    }
+
+    SUBCASE("Copy constructor")
+    {
+        SmallVector4 v2(v1);
+        REQUIRE(v2.size() == v1.size());
+        REQUIRE(std::equal(v1.begin(), v1.end(), v2.begin()));
+        REQUIRE(v2.get_allocator() == v1.get_allocator());
+    }
+
+    SUBCASE("Move constructor")
+    {
+        // Inline elements are moved.
+        SmallVector4 v2(std::move(v1));
+        REQUIRE(v2.is_inline());
+        REQUIRE(v2[3] == "3");
+        REQUIRE(v1.size() == 0);
+
+        // Allocated storage is stolen without allocating.
+        v2.push_back("4");
+        SmallVector4 v3(std::move(v2));
+        REQUIRE(count == 1);
+        REQUIRE(v3.size() == 5);
+        REQUIRE(v3[4] == "4");
+        REQUIRE(v2.size() == 0);
+        REQUIRE(v2.is_inline());
+    }
+
+    SUBCASE("Copy and move assignment")
+    {
+        SmallVector4 v2{CountingAllocator<std::string>(&count)};
+        v2 = v1;
+        REQUIRE(std::equal(v1.begin(), v1.end(), v2.begin()));
+        SmallVector4 v3{CountingAllocator<std::string>(&count)};
+        v3 = std::move(v2);
+        REQUIRE(v3.size() == 4);
+        REQUIRE(v2.size() == 0);
+
+        // Allocators that differ move the elements.
+        int other_count = 0;
+        SmallVector4 v4{CountingAllocator<std::string>(&other_count)};
+        v1.resize(10);
+        v4 = std::move(v1);
+        REQUIRE(v4.size() == 10);
+        REQUIRE(other_count == 1);
+    }
+
+    SUBCASE("Uninitialized storage")
+    {
+        // Only elements added are constructed, and all are destroyed.
+        {
+            SmallVector<Counted, 8> v2;
+            REQUIRE(Counted::alive == 0);
+            for (int i = 0; i != 20; ++i) {
+                v2.emplace_back(i);
+            }
+            REQUIRE(Counted::alive == 20);
+            SmallVector<Counted, 8> v3(v2);
+            REQUIRE(Counted::alive == 40);
+            v2.resize(10, Counted{0});
+            REQUIRE(Counted::alive == 30);
+        }
+        REQUIRE(Counted::alive == 0);
+    }
+}
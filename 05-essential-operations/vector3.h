@@ -0,0 +1,572 @@
+// Resource handle classes for a vector of elements.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// _is_vec_node is true for the nodes of Vector expressions, see below.
+template <typename E>
+struct _is_vec_node : std::false_type {};
+
+template <typename E>
+constexpr bool _is_vec_node_v = _is_vec_node<E>::value;
+
+// Vector demonstrates all the essential operations for a resource handle.
+// Unlike POD-types, resource handles require non-default implementations.
+template <typename T>
+class Vector
+{
+public:
+    // Default constructor.
+    Vector() = default;
+
+    // Ordinary constructor.
+    explicit Vector(std::size_t sz)
+        : elems(new T[sz])
+        , sz(sz)
+    {}
+
+    // Copy constructor.
+    Vector(const Vector<T>& rhs)
+        : elems(new T[rhs.sz])
+        , sz(rhs.sz)
+    {
+        std::copy(cbegin(rhs), cend(rhs), begin(*this));
+    }
+
+    // Constructor from an expression, evaluated in one loop into the only
+    // allocation of the expression.
+    template <typename E, std::enable_if_t<_is_vec_node_v<E>>* = nullptr>
+    Vector(const E& e)
+        : elems(new T[e.size()])
+        , sz(e.size())
+    {
+        for (std::size_t i = 0; i != sz; ++i) {
+            elems[i] = e[i];
+        }
+    }
+
+    // Move constructor.
+    Vector(Vector<T>&& rhs)
+    {
+        std::swap(elems, rhs.elems);
+        std::swap(sz, rhs.sz);
+    }
+
+    // Copy-assignment.
+    Vector& operator=(const Vector<T>& rhs)
+    {
+        Vector tmp(rhs); // Create a defensive copy in case of throw.
+        std::swap(elems, tmp.elems);
+        std::swap(sz, tmp.sz);
+        return *this;
+    }
+
+    // Move-assignment.
+    Vector& operator=(Vector<T>&& rhs)
+    {
+        std::swap(elems, rhs.elems);
+        std::swap(sz, rhs.sz);
+        return *this;
+    }
+
+    // Assignment from an expression, in place when the sizes agree. Each
+    // element depends only on the same element of the operands, so the
+    // expression may refer to this Vector.
+    template <typename E, std::enable_if_t<_is_vec_node_v<E>>* = nullptr>
+    Vector& operator=(const E& e)
+    {
+        if (sz != e.size()) {
+            return *this = Vector(e);
+        }
+        for (std::size_t i = 0; i != sz; ++i) {
+            elems[i] = e[i];
+        }
+        return *this;
+    }
+
+    // Destructor.
+    ~Vector()
+    {
+        delete []elems;
+        sz = 0;
+    }
+
+    // Non-const access to elements of Vector.
+    T& operator[](std::size_t i)
+    {
+        return elems[i];
+    }
+
+    // Const access to elements of Vector.
+    const T& operator[](std::size_t i) const
+    {
+        return elems[i];
+    }
+
+    // Size returns number of elements.
+    std::size_t size() const
+    {
+        return sz;
+    }
+
+private:
+    // Default initial value is empty Vector.
+    T *elems = nullptr;
+    std::size_t sz = 0;
+};
+
+// begin satisfies requirements for range-based for loop.
+template <typename T>
+T* begin(Vector<T>& v)
+{
+    return v.size() ? &v[0] : nullptr;
+}
+
+// end satisfies requirements for range-based for loop.
+template <typename T>
+T* end(Vector<T>& v)
+{
+    return v.size() ? &v[0]+v.size() : nullptr;
+}
+
+// cbegin satisfies requirements for range-based for loop.
+template <typename T>
+const T* cbegin(const Vector<T>& v)
+{
+    return v.size() ? &v[0] : nullptr;
+}
+
+// cend satisfies requirements for range-based for loop.
+template <typename T>
+const T* cend(const Vector<T>& v)
+{
+    return v.size() ? &v[0]+v.size() : nullptr;
+}
+
+// Arithmetic on Vector builds expression templates: a + b returns a node
+// that holds its operands and computes element i on demand, rather than a
+// Vector, so a*x + b*y + z allocates nothing until it is assigned to a Vector,
+// which then evaluates all the operators in a single loop. Nodes hold Vector
+// operands by reference, so store expressions in a Vector, not in auto.
+
+// _is_vec_expr is true for Vector and the nodes of Vector expressions.
+template <typename E>
+constexpr bool _is_vec_expr_v = _is_vec_node_v<E>;
+
+template <typename T>
+constexpr bool _is_vec_expr_v<Vector<T>> = true;
+
+// _vec_operand_t is how nodes hold an operand of type E.
+template <typename E>
+using _vec_operand_t = std::conditional_t<_is_vec_node_v<E>, E, const E&>;
+
+// _VecBinary applies Op to the elements of two expressions of equal size.
+template <typename Op, typename L, typename R>
+class _VecBinary
+{
+public:
+    _VecBinary(const L& l, const R& r)
+        : l(l)
+        , r(r)
+    {
+        if (l.size() != r.size()) {
+            throw std::length_error{"Vector: sizes differ"};
+        }
+    }
+
+    std::size_t size() const { return l.size(); }
+    auto operator[](std::size_t i) const { return Op{}(l[i], r[i]); }
+
+private:
+    _vec_operand_t<L> l;
+    _vec_operand_t<R> r;
+};
+
+// _VecScale multiplies the elements of an expression by a scalar.
+template <typename S, typename E>
+class _VecScale
+{
+public:
+    _VecScale(S s, const E& e)
+        : s(s)
+        , e(e)
+    {}
+
+    std::size_t size() const { return e.size(); }
+    auto operator[](std::size_t i) const { return s * e[i]; }
+
+private:
+    S s;
+    _vec_operand_t<E> e;
+};
+
+template <typename Op, typename L, typename R>
+struct _is_vec_node<_VecBinary<Op, L, R>> : std::true_type {};
+
+template <typename S, typename E>
+struct _is_vec_node<_VecScale<S, E>> : std::true_type {};
+
+template <typename L, typename R,
+          std::enable_if_t<_is_vec_expr_v<L> && _is_vec_expr_v<R>>* = nullptr>
+_VecBinary<std::plus<>, L, R> operator+(const L& l, const R& r)
+{
+    return {l, r};
+}
+
+template <typename L, typename R,
+          std::enable_if_t<_is_vec_expr_v<L> && _is_vec_expr_v<R>>* = nullptr>
+_VecBinary<std::minus<>, L, R> operator-(const L& l, const R& r)
+{
+    return {l, r};
+}
+
+// Elementwise product.
+template <typename L, typename R,
+          std::enable_if_t<_is_vec_expr_v<L> && _is_vec_expr_v<R>>* = nullptr>
+_VecBinary<std::multiplies<>, L, R> operator*(const L& l, const R& r)
+{
+    return {l, r};
+}
+
+template <typename S, typename E,
+          std::enable_if_t<std::is_arithmetic_v<S> && _is_vec_expr_v<E>>* = nullptr>
+_VecScale<S, E> operator*(S s, const E& e)
+{
+    return {s, e};
+}
+
+template <typename S, typename E,
+          std::enable_if_t<std::is_arithmetic_v<S> && _is_vec_expr_v<E>>* = nullptr>
+_VecScale<S, E> operator*(const E& e, S s)
+{
+    return {s, e};
+}
+
+// SmallVector is a Vector that stores up to N elements inline, without
+// allocating, and grows geometrically into storage from Allocator beyond.
+// Unlike Vector, storage is left uninitialized until elements are constructed
+// in place, so only size() elements are ever alive.
+template <typename T, std::size_t N = 8, typename Allocator = std::allocator<T>>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector requires inline capacity");
+
+    using Traits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Default constructor.
+    SmallVector() = default;
+
+    explicit SmallVector(const Allocator& alloc)
+        : alloc(alloc)
+    {}
+
+    // Ordinary constructor, elements are value-initialized.
+    explicit SmallVector(std::size_t sz, const Allocator& alloc = Allocator())
+        : alloc(alloc)
+    {
+        resize(sz);
+    }
+
+    SmallVector(std::size_t sz, const T& value, const Allocator& alloc = Allocator())
+        : alloc(alloc)
+    {
+        reserve(sz);
+        while (this->sz != sz) {
+            emplace_back(value);
+        }
+    }
+
+    SmallVector(std::initializer_list<T> init, const Allocator& alloc = Allocator())
+        : alloc(alloc)
+    {
+        append(init.begin(), init.end());
+    }
+
+    // Copy constructor.
+    SmallVector(const SmallVector& rhs)
+        : alloc(Traits::select_on_container_copy_construction(rhs.alloc))
+    {
+        append(rhs.begin(), rhs.end());
+    }
+
+    SmallVector(const SmallVector& rhs, const Allocator& alloc)
+        : alloc(alloc)
+    {
+        append(rhs.begin(), rhs.end());
+    }
+
+    // Move constructor, steals allocated storage and moves inline elements.
+    SmallVector(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : alloc(std::move(rhs.alloc))
+    {
+        steal(rhs);
+    }
+
+    // Copy-assignment.
+    SmallVector& operator=(const SmallVector& rhs)
+    {
+        if (this != &rhs) {
+            if constexpr (Traits::propagate_on_container_copy_assignment::value) {
+                if (alloc != rhs.alloc) {
+                    release();
+                }
+                alloc = rhs.alloc;
+            }
+            assign(rhs.begin(), rhs.end());
+        }
+        return *this;
+    }
+
+    // Move-assignment.
+    SmallVector& operator=(SmallVector&& rhs)
+        noexcept(std::is_nothrow_move_constructible_v<T> &&
+                 (Traits::propagate_on_container_move_assignment::value ||
+                  Traits::is_always_equal::value))
+    {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (Traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc = std::move(rhs.alloc);
+            steal(rhs);
+        }
+        else {
+            if (alloc == rhs.alloc) {
+                release();
+                steal(rhs);
+            }
+            else {
+                // Storage of rhs cannot be freed by alloc, so move elements.
+                assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+                rhs.clear();
+            }
+        }
+        return *this;
+    }
+
+    // Destructor.
+    ~SmallVector()
+    {
+        release();
+    }
+
+    T& operator[](std::size_t i) { return elems[i]; }
+    const T& operator[](std::size_t i) const { return elems[i]; }
+
+    T& front() { return elems[0]; }
+    const T& front() const { return elems[0]; }
+    T& back() { return elems[sz - 1]; }
+    const T& back() const { return elems[sz - 1]; }
+
+    T* data() { return elems; }
+    const T* data() const { return elems; }
+
+    iterator begin() { return elems; }
+    iterator end() { return elems + sz; }
+    const_iterator begin() const { return elems; }
+    const_iterator end() const { return elems + sz; }
+
+    std::size_t size() const { return sz; }
+    std::size_t capacity() const { return cap; }
+    bool empty() const { return sz == 0; }
+
+    // is_inline is true while elements are stored inline.
+    bool is_inline() const { return elems == inline_elems(); }
+
+    allocator_type get_allocator() const { return alloc; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (sz == cap) {
+            return grow_emplace_back(std::forward<Args>(args)...);
+        }
+        Traits::construct(alloc, elems + sz, std::forward<Args>(args)...);
+        return elems[sz++];
+    }
+
+    void pop_back()
+    {
+        Traits::destroy(alloc, elems + --sz);
+    }
+
+    void clear()
+    {
+        while (sz != 0) {
+            pop_back();
+        }
+    }
+
+    void reserve(std::size_t n)
+    {
+        if (n > cap) {
+            reallocate(n);
+        }
+    }
+
+    void resize(std::size_t n)
+    {
+        reserve(n);
+        while (sz < n) {
+            emplace_back();
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+    void resize(std::size_t n, const T& value)
+    {
+        reserve(n);
+        while (sz < n) {
+            emplace_back(value);
+        }
+        while (sz > n) {
+            pop_back();
+        }
+    }
+
+private:
+    T* inline_elems() { return reinterpret_cast<T*>(buffer); }
+    const T* inline_elems() const { return reinterpret_cast<const T*>(buffer); }
+
+    template <typename InputIterator>
+    void append(InputIterator first, InputIterator last)
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<InputIterator>::iterator_category>) {
+            reserve(sz + std::distance(first, last));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    template <typename InputIterator>
+    void assign(InputIterator first, InputIterator last)
+    {
+        clear();
+        append(first, last);
+    }
+
+    // steal takes the elements of rhs, which is left empty and inline, and
+    // requires this to be empty and inline.
+    void steal(SmallVector& rhs)
+    {
+        if (rhs.is_inline()) {
+            for (std::size_t i = 0; i != rhs.sz; ++i) {
+                Traits::construct(alloc, elems + i, std::move(rhs.elems[i]));
+            }
+            sz = rhs.sz;
+            rhs.clear();
+        }
+        else {
+            elems = std::exchange(rhs.elems, rhs.inline_elems());
+            sz = std::exchange(rhs.sz, 0);
+            cap = std::exchange(rhs.cap, N);
+        }
+    }
+
+    // release destroys the elements and frees allocated storage.
+    void release()
+    {
+        clear();
+        if (!is_inline()) {
+            Traits::deallocate(alloc, elems, cap);
+            elems = inline_elems();
+            cap = N;
+        }
+    }
+
+    // move_elements moves the elements to storage at to, destroying them.
+    void move_elements(T* to)
+    {
+        std::size_t i = 0;
+        try {
+            for (; i != sz; ++i) {
+                Traits::construct(alloc, to + i, std::move_if_noexcept(elems[i]));
+            }
+        }
+        catch (...) {
+            while (i != 0) {
+                Traits::destroy(alloc, to + --i);
+            }
+            throw;
+        }
+        for (i = 0; i != sz; ++i) {
+            Traits::destroy(alloc, elems + i);
+        }
+    }
+
+    void adopt(T* storage, std::size_t n)
+    {
+        if (!is_inline()) {
+            Traits::deallocate(alloc, elems, cap);
+        }
+        elems = storage;
+        cap = n;
+    }
+
+    void reallocate(std::size_t n)
+    {
+        T* storage = Traits::allocate(alloc, n);
+        try {
+            move_elements(storage);
+        }
+        catch (...) {
+            Traits::deallocate(alloc, storage, n);
+            throw;
+        }
+        adopt(storage, n);
+    }
+
+    // grow_emplace_back constructs the new element before moving the others,
+    // since args may refer to one of them.
+    template <typename... Args>
+    T& grow_emplace_back(Args&&... args)
+    {
+        std::size_t n = 2 * cap;
+        T* storage = Traits::allocate(alloc, n);
+        try {
+            Traits::construct(alloc, storage + sz, std::forward<Args>(args)...);
+            try {
+                move_elements(storage);
+            }
+            catch (...) {
+                Traits::destroy(alloc, storage + sz);
+                throw;
+            }
+        }
+        catch (...) {
+            Traits::deallocate(alloc, storage, n);
+            throw;
+        }
+        adopt(storage, n);
+        return elems[sz++];
+    }
+
+    Allocator alloc;
+    alignas(T) unsigned char buffer[N * sizeof(T)];
+    T* elems = inline_elems();
+    std::size_t sz = 0;
+    std::size_t cap = N;
+};
@@ -0,0 +1,45 @@
+// Benchmark short-lived Vector, std::vector and SmallVector.
+#include <numeric>
+#include <vector>
+
+#include "vector3.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Each iteration builds a vector of state.arg() elements, sums it and
+// destroys it, as do functions returning a few results.
+template <typename Vec>
+void bench_push_back(timeit::State& state)
+{
+    int n = state.arg();
+    while (state.keep_running()) {
+        Vec v;
+        for (int i = 0; i != n; ++i) {
+            timeit::do_not_optimize(i);
+            v.push_back(i);
+        }
+        timeit::do_not_optimize(std::accumulate(v.begin(), v.end(), 0));
+    }
+    state.set_items_processed(n);
+}
+
+#define VECTOR_SIZES 2, 4, 8, 16, 64
+
+TIMEIT_BENCHMARK_ARGS("[short-lived:Vector]", VECTOR_SIZES)
+{
+    // Vector cannot grow, so its size is known up front.
+    int n = state.arg();
+    while (state.keep_running()) {
+        Vector<int> v(n);
+        for (int i = 0; i != n; ++i) {
+            timeit::do_not_optimize(i);
+            v[i] = i;
+        }
+        timeit::do_not_optimize(std::accumulate(cbegin(v), cend(v), 0));
+    }
+    state.set_items_processed(n);
+}
+
+TIMEIT_BENCHMARK_ARGS("[short-lived:std::vector]", VECTOR_SIZES) { bench_push_back<std::vector<int>>(state); }
+TIMEIT_BENCHMARK_ARGS("[short-lived:SmallVector<8>]", VECTOR_SIZES) { bench_push_back<SmallVector<int, 8>>(state); }
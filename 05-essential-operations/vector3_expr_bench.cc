@@ -0,0 +1,116 @@
+// Benchmark Vector expressions against vectors returned by each operator and
+// a loop written by hand. The allocations are counted by replacing operator
+// new, which applies to the whole program, so these benchmarks are built on
+// their own.
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "vector3.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// num_allocs counts the calls to operator new, which new[] calls too.
+static std::size_t num_allocs = 0;
+
+// The replacements are not inlined, else GCC sees a pointer from malloc
+// passed to operator delete, or from operator new passed to free, and warns
+// of a mismatch.
+[[gnu::noinline]] void* operator new(std::size_t n)
+{
+    ++num_allocs;
+    if (void* p = std::malloc(n ? n : 1)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// NaiveVector has the obvious operators, which return a new vector each.
+struct NaiveVector
+{
+    std::vector<double> v;
+
+    friend NaiveVector operator+(const NaiveVector& l, const NaiveVector& r)
+    {
+        NaiveVector out{std::vector<double>(l.v.size())};
+        for (std::size_t i = 0; i != l.v.size(); ++i) {
+            out.v[i] = l.v[i] + r.v[i];
+        }
+        return out;
+    }
+
+    friend NaiveVector operator*(double s, const NaiveVector& r)
+    {
+        NaiveVector out{std::vector<double>(r.v.size())};
+        for (std::size_t i = 0; i != r.v.size(); ++i) {
+            out.v[i] = s * r.v[i];
+        }
+        return out;
+    }
+};
+
+// Each iteration evaluates the 5 term axpy a*x1 + b*x2 + c*x3 + d*x4 + e*x5
+// into a new vector of state.arg() elements.
+constexpr double a = 1., b = 2., c = 3., d = 4., e = 5.;
+
+template <typename Vec, typename Make, typename Axpy>
+void bench_axpy(timeit::State& state, Make make, Axpy axpy)
+{
+    std::size_t n = state.arg();
+    Vec x1 = make(n), x2 = make(n), x3 = make(n), x4 = make(n), x5 = make(n);
+    std::size_t allocs = 0, num_iter = 0;
+    while (state.keep_running()) {
+        auto start = num_allocs;
+        auto r = axpy(x1, x2, x3, x4, x5);
+        allocs += num_allocs - start;
+        ++num_iter;
+        timeit::do_not_optimize(r);
+        timeit::clobber_memory(); // Keep the stores to r.
+    }
+    state.counters["allocs"] = static_cast<double>(allocs) / num_iter;
+    state.set_bytes_processed(6 * n * sizeof(double));
+}
+
+#define AXPY_SIZES 1'000, 100'000, 10'000'000
+
+TIMEIT_BENCHMARK_ARGS("[axpy5:NaiveVector]", AXPY_SIZES)
+{
+    bench_axpy<NaiveVector>(state,
+        [](std::size_t n) { return NaiveVector{std::vector<double>(n, 1.)}; },
+        [](auto& x1, auto& x2, auto& x3, auto& x4, auto& x5) {
+            return a*x1 + b*x2 + c*x3 + d*x4 + e*x5;
+        });
+}
+
+TIMEIT_BENCHMARK_ARGS("[axpy5:Vector]", AXPY_SIZES)
+{
+    bench_axpy<Vector<double>>(state,
+        [](std::size_t n) {
+            Vector<double> x(n);
+            std::fill(begin(x), end(x), 1.);
+            return x;
+        },
+        [](auto& x1, auto& x2, auto& x3, auto& x4, auto& x5) {
+            return Vector<double>(a*x1 + b*x2 + c*x3 + d*x4 + e*x5);
+        });
+}
+
+TIMEIT_BENCHMARK_ARGS("[axpy5:loop]", AXPY_SIZES)
+{
+    // The loop one would write by hand.
+    bench_axpy<std::vector<double>>(state,
+        [](std::size_t n) { return std::vector<double>(n, 1.); },
+        [](auto& x1, auto& x2, auto& x3, auto& x4, auto& x5) {
+            std::vector<double> r(x1.size());
+            for (std::size_t i = 0; i != r.size(); ++i) {
+                r[i] = a*x1[i] + b*x2[i] + c*x3[i] + d*x4[i] + e*x5[i];
+            }
+            return r;
+        });
+}
@@ -1,28 +1,17 @@
 // Implement function template equivalent to std::accumulate.
+#include <cmath>
 #include <cstdint>
 #include <iterator>
+#include <list>
 #include <numeric>
+#include <random>
 #include <vector>
 
+#include "accumulate.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Wrap in mystd to avoid collison with std::accumulate.
-namespace mystd {
-
-// accumulate returns the sum of the elements in range [first, last).
-template <typename FwdIter, typename T = typename std::iterator_traits<FwdIter>::value_type>
-T accumulate(FwdIter first, FwdIter last, T value)
-{
-    while (first != last) {
-        value += *first;
-        ++first;
-    }
-    return value;
-}
-
-}
-
 TEST_CASE("[accumulate]")
 {
     SUBCASE("Sum with 0 initial value")
@@ -56,3 +45,74 @@ TEST_CASE("[accumulate]")
         REQUIRE(rcv == expected);
     }
 }
+
+TEST_CASE("[accumulate:policies]")
+{
+    namespace ex = mystd::execution;
+
+    SUBCASE("Integers sum exactly under every policy")
+    {
+        std::vector<std::uint8_t> v1(1'000'003, 255); // Overflow if accumulate as uint8_t.
+        std::int64_t expected = 255 * std::int64_t(std::size(v1)) + 10;
+        REQUIRE(mystd::accumulate(ex::seq, std::begin(v1), std::end(v1), std::int64_t{10}) == expected);
+        REQUIRE(mystd::accumulate(ex::unseq, std::begin(v1), std::end(v1), std::int64_t{10}) == expected);
+        REQUIRE(mystd::accumulate(ex::par, std::begin(v1), std::end(v1), std::int64_t{10}) == expected);
+        REQUIRE(mystd::accumulate(ex::parallel_policy{4}, std::begin(v1), std::end(v1), std::int64_t{10}) == expected);
+        REQUIRE(mystd::accumulate(ex::compensated, std::begin(v1), std::end(v1), std::int64_t{10}) == expected);
+    }
+
+    SUBCASE("Empty and short ranges")
+    {
+        std::vector<double> v1;
+        REQUIRE(mystd::accumulate(ex::unseq, std::begin(v1), std::end(v1), 2.5) == 2.5);
+        REQUIRE(mystd::accumulate(ex::par, std::begin(v1), std::end(v1), 2.5) == 2.5);
+        REQUIRE(mystd::accumulate(ex::compensated, std::begin(v1), std::end(v1), 2.5) == 2.5);
+        for (int n = 1; n != 100; ++n) {
+            v1.push_back(n);
+            double expected = n * (n + 1) / 2 + 2.5;
+            REQUIRE(mystd::accumulate(ex::unseq, std::begin(v1), std::end(v1), 2.5) == expected);
+            REQUIRE(mystd::accumulate(ex::compensated, std::begin(v1), std::end(v1), 2.5) == expected);
+        }
+    }
+
+    SUBCASE("Ranges that are not contiguous")
+    {
+        std::list<double> l1{2.5, -7.5, 2.5};
+        auto expected = std::accumulate(std::begin(l1), std::end(l1), 2.5);
+        REQUIRE(mystd::accumulate(ex::unseq, std::begin(l1), std::end(l1), 2.5) == expected);
+        REQUIRE(mystd::accumulate(ex::par, std::begin(l1), std::end(l1), 2.5) == expected);
+        REQUIRE(mystd::accumulate(ex::compensated, std::begin(l1), std::end(l1), 2.5) == expected);
+    }
+
+    SUBCASE("Compensated sum of terms lost by accumulate")
+    {
+        // Each 1 is lost when added to 1e16, whose ulp is 2.
+        std::vector<double> v1(1000, 1.);
+        v1.insert(std::begin(v1), 1e16);
+        REQUIRE(mystd::accumulate(std::begin(v1), std::end(v1), 0.) == 1e16);
+        REQUIRE(mystd::accumulate(ex::compensated, std::begin(v1), std::end(v1), 0.) == 1e16 + 1000);
+        std::list<double> l1(std::begin(v1), std::end(v1));
+        REQUIRE(mystd::accumulate(ex::compensated, std::begin(l1), std::end(l1), 0.) == 1e16 + 1000);
+    }
+
+    SUBCASE("Compare to std::reduce")
+    {
+        std::vector<double> v1(1'000'000);
+        std::default_random_engine gen{};
+        std::uniform_real_distribution<double> dist{0., 1.};
+        for (auto& x : v1) {
+            x = dist(gen);
+        }
+        auto expected = mystd::accumulate(ex::compensated, std::begin(v1), std::end(v1), 0.);
+        auto reduced = std::reduce(std::begin(v1), std::end(v1), 0.);
+        auto tol = 1e-9 * expected;
+        REQUIRE(std::abs(reduced - expected) < tol);
+        REQUIRE(std::abs(mystd::accumulate(ex::unseq, std::begin(v1), std::end(v1), 0.) - expected) < tol);
+        REQUIRE(std::abs(mystd::accumulate(ex::par, std::begin(v1), std::end(v1), 0.) - expected) < tol);
+        for (unsigned num_threads : {2, 3, 16}) {
+            auto rcv = mystd::accumulate(ex::parallel_policy{num_threads},
+                                         std::begin(v1), std::end(v1), 0.);
+            REQUIRE(std::abs(rcv - expected) < tol);
+        }
+    }
+}
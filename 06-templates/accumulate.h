@@ -0,0 +1,202 @@
+// Function template equivalent to std::accumulate with execution policies.
+//
+// accumulate adds the elements one after the other, so each add waits for
+// the previous one and, since floating-point addition is not associative, the
+// compiler may not reorder the adds into vector lanes. The policies of
+// mystd::execution allow reordering as std::reduce does: unseq adds the
+// elements of a contiguous range of arithmetic type into many independent
+// accumulators, which the compiler keeps in vector registers, par adds chunks
+// of the range on separate threads, and compensated carries the rounding error
+// of each add in the manner of Kahan, so the error does not grow with the
+// length of the range. The result of unseq and par may differ from that of
+// accumulate in the last bits, as for std::reduce.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "execution.h"
+
+// Wrap in mystd to avoid collison with std::accumulate.
+namespace mystd {
+
+// accumulate returns the sum of the elements in range [first, last).
+template <typename FwdIter, typename T = typename std::iterator_traits<FwdIter>::value_type>
+T accumulate(FwdIter first, FwdIter last, T value)
+{
+    while (first != last) {
+        value += *first;
+        ++first;
+    }
+    return value;
+}
+
+template <typename FwdIter, typename T>
+T accumulate(execution::sequenced_policy, FwdIter first, FwdIter last, T value)
+{
+    return mystd::accumulate(first, last, value);
+}
+
+// _accumulate_lanes is the number of accumulators of unseq, 4 vectors of 64
+// bytes, enough to hide the latency of the adds of 2 ports.
+template <typename T>
+constexpr std::size_t _accumulate_lanes = 4 * 64 / sizeof(T);
+
+// _accumulate_unseq adds f of each of the n elements at p to value in
+// independent lanes.
+template <typename T, typename U, typename F>
+T _accumulate_unseq(const U* p, std::size_t n, T value, F f)
+{
+    constexpr std::size_t lanes = _accumulate_lanes<T>;
+    T acc[lanes] = {};
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t l = 0; l != lanes; ++l) {
+            acc[l] += f(p[i + l]);
+        }
+    }
+    for (; i != n; ++i) {
+        acc[i % lanes] += f(p[i]);
+    }
+    // Add the lanes pairwise.
+    for (std::size_t width = lanes / 2; width != 0; width /= 2) {
+        for (std::size_t l = 0; l != width; ++l) {
+            acc[l] += acc[l + width];
+        }
+    }
+    return value + acc[0];
+}
+
+template <typename T, typename U>
+T _accumulate_unseq(const U* p, std::size_t n, T value)
+{
+    return _accumulate_unseq(p, n, value, [](const U& x) { return x; });
+}
+
+template <typename FwdIter, typename T>
+T accumulate(execution::unsequenced_policy, FwdIter first, FwdIter last, T value)
+{
+    using U = typename std::iterator_traits<FwdIter>::value_type;
+    if constexpr (_is_contiguous_iterator<FwdIter> && std::is_arithmetic_v<T> &&
+                  std::is_arithmetic_v<U>) {
+        if (first == last) {
+            return value;
+        }
+        return _accumulate_unseq(std::addressof(*first),
+                                 std::distance(first, last), value);
+    }
+    else {
+        return mystd::accumulate(first, last, value);
+    }
+}
+
+// par adds the chunks of a random access range on up to num_threads threads,
+// each with unseq, and the sums of the chunks in order.
+template <typename FwdIter, typename T>
+T accumulate(execution::parallel_policy policy, FwdIter first, FwdIter last, T value)
+{
+    if constexpr (!_is_random_access_iterator<FwdIter>) {
+        return mystd::accumulate(first, last, value);
+    }
+    else {
+        std::size_t num_chunks = _num_chunks(policy, std::distance(first, last));
+        if (num_chunks == 1) {
+            return mystd::accumulate(execution::unseq, first, last, value);
+        }
+        std::vector<T> sums(num_chunks, T{});
+        _for_each_chunk(first, last, num_chunks,
+            [&sums](std::size_t t, FwdIter lo, FwdIter hi) {
+                sums[t] = mystd::accumulate(execution::unseq, lo, hi, T{});
+            });
+        return mystd::accumulate(sums.begin(), sums.end(), value);
+    }
+}
+
+// _Kahan is a sum carrying the low bits lost by its last add.
+template <typename T>
+struct _Kahan
+{
+    void add(T x)
+    {
+        T y = x - c;
+        T t = sum + y;
+        c = (t - sum) - y; // The low bits of y lost by the add.
+        sum = t;
+    }
+
+    void add(const _Kahan& k)
+    {
+        add(k.sum);
+        add(-k.c);
+    }
+
+    T value() const { return sum - c; }
+
+    T sum = T{};
+    T c = T{};
+};
+
+// _accumulate_compensated adds the n elements at p to value in independent
+// Kahan sums, as many as the lanes of unseq since each add is a chain of 4.
+template <typename T, typename U>
+T _accumulate_compensated(const U* p, std::size_t n, T value)
+{
+    constexpr std::size_t lanes = _accumulate_lanes<T>;
+    // The sums and compensations are kept apart to be loaded as vectors.
+    T sum[lanes] = {}, c[lanes] = {};
+    auto add = [&](std::size_t l, T x) {
+        T y = x - c[l];
+        T t = sum[l] + y;
+        c[l] = (t - sum[l]) - y;
+        sum[l] = t;
+    };
+    std::size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t l = 0; l != lanes; ++l) {
+            add(l, p[i + l]);
+        }
+    }
+    for (; i != n; ++i) {
+        add(i % lanes, p[i]);
+    }
+    _Kahan<T> total;
+    total.add(value);
+    for (std::size_t l = 0; l != lanes; ++l) {
+        total.add(_Kahan<T>{sum[l], c[l]});
+    }
+    return total.value();
+}
+
+// compensated adds the floating-point elements in Kahan sums, so the error
+// is bounded by a few units in the last place of the result whatever the
+// length of the range. -ffast-math, which assumes (s + x) - s == x, undoes
+// the compensation.
+template <typename FwdIter, typename T>
+T accumulate(execution::compensated_policy, FwdIter first, FwdIter last, T value)
+{
+    using U = typename std::iterator_traits<FwdIter>::value_type;
+    if constexpr (!std::is_floating_point_v<T>) {
+        return mystd::accumulate(first, last, value);
+    }
+    else if constexpr (_is_contiguous_iterator<FwdIter> && std::is_arithmetic_v<U>) {
+        if (first == last) {
+            return value;
+        }
+        return _accumulate_compensated(std::addressof(*first),
+                                       std::distance(first, last), value);
+    }
+    else {
+        _Kahan<T> total;
+        total.add(value);
+        while (first != last) {
+            total.add(*first);
+            ++first;
+        }
+        return total.value();
+    }
+}
+
+}
@@ -0,0 +1,93 @@
+// Benchmark mystd::accumulate policies against std::accumulate and std::reduce.
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "accumulate.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Data is a range of random doubles with its sum in long double.
+struct Data
+{
+    std::vector<double> values;
+    long double sum = 0;
+};
+
+// make_data returns n random doubles.
+Data make_data(std::size_t n)
+{
+    Data d;
+    d.values.assign(n, 0.);
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 1.};
+    for (auto& x : d.values) {
+        x = dist(gen);
+    }
+    d.sum = mystd::accumulate(mystd::execution::compensated,
+                              d.values.begin(), d.values.end(), 0.L);
+    return d;
+}
+
+// bench_sum reports the relative error of sum against the long double sum.
+template <typename Sum>
+void bench_sum(timeit::State& state, Sum sum)
+{
+    auto d = make_data(state.arg());
+    double result = 0;
+    while (state.keep_running()) {
+        result = sum(d.values.begin(), d.values.end());
+        timeit::do_not_optimize(result);
+    }
+    state.counters["rel_error"] = static_cast<double>(
+        std::abs((result - d.sum) / d.sum));
+    state.set_bytes_processed(d.values.size() * sizeof(double));
+}
+
+#define SUM_SIZES 1'000, 1'000'000, 100'000'000
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:std::accumulate]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return std::accumulate(first, last, 0.);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:std::reduce]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return std::reduce(first, last, 0.);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:seq]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return mystd::accumulate(mystd::execution::seq, first, last, 0.);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:unseq]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return mystd::accumulate(mystd::execution::unseq, first, last, 0.);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:par]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return mystd::accumulate(mystd::execution::par, first, last, 0.);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[accumulate:compensated]", SUM_SIZES)
+{
+    bench_sum(state, [](auto first, auto last) {
+        return mystd::accumulate(mystd::execution::compensated, first, last, 0.);
+    });
+}
@@ -1,46 +1,16 @@
 // Implement function template equivalent to std::count_if with UnaryPredicate.
+#include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <list>
+#include <random>
 #include <vector>
 
+#include "count_if.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Wrap in mystd to avoid collison with std::count_if.
-namespace mystd {
-
-// count_if returns the count of elements in [first, last) that satisfy UnaryPredicate.
-template <typename FwdIter, typename UnaryPredicate>
-typename std::iterator_traits<FwdIter>::difference_type // Difference of iterators.
-count_if(FwdIter first, FwdIter last, UnaryPredicate pred)
-{
-    typename std::iterator_traits<FwdIter>::difference_type count = 0;
-    while (first != last) {
-        if (pred(*first)) {
-            ++count;
-        }
-        ++first;
-    }
-    return count;
-}
-
-// LessThan returns true when x < thresh.
-template <typename T>
-struct LessThan
-{
-    LessThan(const T& thresh)
-        : thresh(thresh)
-    {}
-
-    bool operator()(const T& x)
-    {
-        return x < thresh;
-    }
-
-    T thresh;
-};
-
-}
-
 TEST_CASE("[count_if]")
 {
     SUBCASE("count_if using functor")
@@ -73,3 +43,73 @@ TEST_CASE("[count_if]")
         REQUIRE(rcv == expected);
     }
 }
+
+TEST_CASE("[count_if:threshold]")
+{
+    SUBCASE("Compare to std::count_if on random data")
+    {
+        std::default_random_engine gen{};
+        std::uniform_real_distribution<double> dist{-1., 1.};
+        std::vector<double> v1(1000);
+        for (auto& x : v1) {
+            x = dist(gen);
+        }
+        std::vector<float> v2(std::begin(v1), std::end(v1));
+        std::vector<int> v3(std::size(v1));
+        std::transform(std::begin(v1), std::end(v1), std::begin(v3),
+                       [](double x) { return static_cast<int>(x * 100); });
+        // Every length checks the vector loop and the scalar remainder.
+        for (std::size_t n = 0; n != 40; ++n) {
+            auto last1 = std::begin(v1) + n;
+            auto last2 = std::begin(v2) + n;
+            auto last3 = std::begin(v3) + n;
+            REQUIRE(mystd::count_if(std::begin(v1), last1, mystd::LessThan(0.25)) ==
+                    std::count_if(std::begin(v1), last1, [](double x) { return x < 0.25; }));
+            REQUIRE(mystd::count_if(std::begin(v2), last2, mystd::GreaterThan(0.25f)) ==
+                    std::count_if(std::begin(v2), last2, [](float x) { return x > 0.25f; }));
+            REQUIRE(mystd::count_if(std::begin(v3), last3, mystd::LessThan(25)) ==
+                    std::count_if(std::begin(v3), last3, [](int x) { return x < 25; }));
+        }
+        REQUIRE(mystd::count_if(std::begin(v1), std::end(v1), mystd::GreaterThan(0.)) ==
+                std::count_if(std::begin(v1), std::end(v1), [](double x) { return x > 0.; }));
+    }
+
+    SUBCASE("NaN satisfies neither LessThan nor GreaterThan")
+    {
+        std::vector<double> v1(20, std::nan(""));
+        v1[3] = -1.;
+        v1[17] = 1.;
+        REQUIRE(mystd::count_if(std::begin(v1), std::end(v1), mystd::LessThan(0.)) == 1);
+        REQUIRE(mystd::count_if(std::begin(v1), std::end(v1), mystd::GreaterThan(0.)) == 1);
+    }
+
+    SUBCASE("Elements compared as the type of the threshold")
+    {
+        std::vector<double> v1{0.5, 1.5, 2.5, -0.5};
+        // As for LessThan<int>::operator(), 0.5 and -0.5 convert to 0.
+        REQUIRE(mystd::count_if(std::begin(v1), std::end(v1), mystd::LessThan(1)) == 2);
+        std::list<double> l1(std::begin(v1), std::end(v1));
+        REQUIRE(mystd::count_if(std::begin(l1), std::end(l1), mystd::LessThan(1)) == 2);
+    }
+
+    SUBCASE("Compare par to seq")
+    {
+        std::default_random_engine gen{};
+        std::uniform_int_distribution<int> dist{0, 99};
+        std::vector<int> v1(1'000'003);
+        for (auto& x : v1) {
+            x = dist(gen);
+        }
+        auto expected = mystd::count_if(mystd::execution::seq, std::begin(v1), std::end(v1),
+                                        [](int x) { return x < 30; });
+        REQUIRE(mystd::count_if(mystd::execution::par, std::begin(v1), std::end(v1),
+                                mystd::LessThan(30)) == expected);
+        for (unsigned num_threads : {2, 3, 16}) {
+            mystd::execution::parallel_policy par{num_threads};
+            REQUIRE(mystd::count_if(par, std::begin(v1), std::end(v1),
+                                    mystd::LessThan(30)) == expected);
+            REQUIRE(mystd::count_if(par, std::begin(v1), std::end(v1),
+                                    [](int x) { return x < 30; }) == expected);
+        }
+    }
+}
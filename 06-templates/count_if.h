@@ -0,0 +1,180 @@
+// Function template equivalent to std::count_if with UnaryPredicate.
+//
+// count_if branches on the predicate of each element, which on random data
+// is mispredicted for about half of the elements. When the predicate is a
+// comparison with a threshold, LessThan or GreaterThan, and the range is a
+// contiguous array of arithmetic type, count_if instead adds the result of
+// each comparison as 0 or 1. For float and double the comparisons are made a
+// vector at a time into a bit mask whose set bits are counted with popcount.
+// Under par, a random access range is split into chunks counted on separate
+// threads.
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+#include "execution.h"
+
+// Wrap in mystd to avoid collison with std::count_if.
+namespace mystd {
+
+// LessThan returns true when x < thresh.
+template <typename T>
+struct LessThan
+{
+    LessThan(const T& thresh)
+        : thresh(thresh)
+    {}
+
+    bool operator()(const T& x) const
+    {
+        return x < thresh;
+    }
+
+    T thresh;
+};
+
+// GreaterThan returns true when x > thresh.
+template <typename T>
+struct GreaterThan
+{
+    GreaterThan(const T& thresh)
+        : thresh(thresh)
+    {}
+
+    bool operator()(const T& x) const
+    {
+        return x > thresh;
+    }
+
+    T thresh;
+};
+
+// _threshold_compare is -1 for LessThan, 1 for GreaterThan and 0 for other
+// predicates.
+template <typename Pred>
+constexpr int _threshold_compare = 0;
+
+template <typename T>
+constexpr int _threshold_compare<LessThan<T>> = -1;
+
+template <typename T>
+constexpr int _threshold_compare<GreaterThan<T>> = 1;
+
+// _count_threshold counts the n elements at p that compare with thresh as
+// Compare, without branches.
+template <int Compare, typename T, typename U>
+std::ptrdiff_t _count_threshold(const U* p, std::size_t n, const T& thresh)
+{
+    std::ptrdiff_t count = 0;
+    std::size_t i = 0;
+#if defined(__AVX512F__)
+    // Ordered comparisons are false for NaN, as are < and >.
+    constexpr int cmp = Compare < 0 ? _CMP_LT_OQ : _CMP_GT_OQ;
+    if constexpr (std::is_same_v<U, T> && std::is_same_v<T, double>) {
+        const __m512d t = _mm512_set1_pd(thresh);
+        for (; i + 8 <= n; i += 8) {
+            count += __builtin_popcount(_mm512_cmp_pd_mask(_mm512_loadu_pd(p + i), t, cmp));
+        }
+    }
+    else if constexpr (std::is_same_v<U, T> && std::is_same_v<T, float>) {
+        const __m512 t = _mm512_set1_ps(thresh);
+        for (; i + 16 <= n; i += 16) {
+            count += __builtin_popcount(_mm512_cmp_ps_mask(_mm512_loadu_ps(p + i), t, cmp));
+        }
+    }
+#elif defined(__AVX__)
+    constexpr int cmp = Compare < 0 ? _CMP_LT_OQ : _CMP_GT_OQ;
+    if constexpr (std::is_same_v<U, T> && std::is_same_v<T, double>) {
+        const __m256d t = _mm256_set1_pd(thresh);
+        for (; i + 4 <= n; i += 4) {
+            count += __builtin_popcount(_mm256_movemask_pd(
+                _mm256_cmp_pd(_mm256_loadu_pd(p + i), t, cmp)));
+        }
+    }
+    else if constexpr (std::is_same_v<U, T> && std::is_same_v<T, float>) {
+        const __m256 t = _mm256_set1_ps(thresh);
+        for (; i + 8 <= n; i += 8) {
+            count += __builtin_popcount(_mm256_movemask_ps(
+                _mm256_cmp_ps(_mm256_loadu_ps(p + i), t, cmp)));
+        }
+    }
+#endif
+    // Compared as T like the predicate, which the compiler vectorizes.
+    for (; i != n; ++i) {
+        const T x = p[i];
+        count += Compare < 0 ? x < thresh : x > thresh;
+    }
+    return count;
+}
+
+// count_if returns the count of elements in [first, last) that satisfy UnaryPredicate.
+template <typename FwdIter, typename UnaryPredicate>
+typename std::iterator_traits<FwdIter>::difference_type // Difference of iterators.
+count_if(FwdIter first, FwdIter last, UnaryPredicate pred)
+{
+    using U = typename std::iterator_traits<FwdIter>::value_type;
+    constexpr int compare = _threshold_compare<UnaryPredicate>;
+    if constexpr (compare != 0 && _is_contiguous_iterator<FwdIter> &&
+                  std::is_arithmetic_v<U>) {
+        if (first == last) {
+            return 0;
+        }
+        return _count_threshold<compare>(std::addressof(*first),
+                                         std::distance(first, last), pred.thresh);
+    }
+    else {
+        typename std::iterator_traits<FwdIter>::difference_type count = 0;
+        while (first != last) {
+            if (pred(*first)) {
+                ++count;
+            }
+            ++first;
+        }
+        return count;
+    }
+}
+
+template <typename FwdIter, typename UnaryPredicate>
+typename std::iterator_traits<FwdIter>::difference_type
+count_if(execution::sequenced_policy, FwdIter first, FwdIter last, UnaryPredicate pred)
+{
+    return mystd::count_if(first, last, pred);
+}
+
+// par counts the chunks of a random access range on up to num_threads
+// threads, each with a copy of pred.
+template <typename FwdIter, typename UnaryPredicate>
+typename std::iterator_traits<FwdIter>::difference_type
+count_if(execution::parallel_policy policy, FwdIter first, FwdIter last, UnaryPredicate pred)
+{
+    using Difference = typename std::iterator_traits<FwdIter>::difference_type;
+    if constexpr (!_is_random_access_iterator<FwdIter>) {
+        return mystd::count_if(first, last, pred);
+    }
+    else {
+        std::size_t num_chunks = _num_chunks(policy, std::distance(first, last));
+        if (num_chunks == 1) {
+            return mystd::count_if(first, last, pred);
+        }
+        std::vector<Difference> counts(num_chunks);
+        _for_each_chunk(first, last, num_chunks,
+            [&counts, &pred](std::size_t t, FwdIter lo, FwdIter hi) {
+                counts[t] = mystd::count_if(lo, hi, pred);
+            });
+        Difference count = 0;
+        for (auto c : counts) {
+            count += c;
+        }
+        return count;
+    }
+}
+
+}
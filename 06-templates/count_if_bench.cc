@@ -0,0 +1,63 @@
+// Benchmark mystd::count_if with threshold predicates on random data.
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "count_if.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_data returns n doubles uniform in [0, 1), half of them less than 0.5
+// in no order a branch predictor can learn.
+std::vector<double> make_data(std::size_t n)
+{
+    std::vector<double> values(n);
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 1.};
+    for (auto& x : values) {
+        x = dist(gen);
+    }
+    return values;
+}
+
+template <typename Count>
+void bench_count(timeit::State& state, Count count)
+{
+    auto values = make_data(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(count(values.begin(), values.end()));
+    }
+    state.set_items_processed(values.size());
+    state.set_bytes_processed(values.size() * sizeof(double));
+}
+
+#define COUNT_SIZES 1'000, 1'000'000, 100'000'000
+
+TIMEIT_BENCHMARK_ARGS("[count_if:lambda]", COUNT_SIZES)
+{
+    // A lambda is not recognized as a threshold, so each element branches.
+    double thresh = 0.5;
+    timeit::do_not_optimize(thresh);
+    bench_count(state, [thresh](auto first, auto last) {
+        return mystd::count_if(first, last, [thresh](double x) { return x < thresh; });
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[count_if:LessThan]", COUNT_SIZES)
+{
+    double thresh = 0.5;
+    timeit::do_not_optimize(thresh);
+    bench_count(state, [thresh](auto first, auto last) {
+        return mystd::count_if(first, last, mystd::LessThan(thresh));
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[count_if:par]", COUNT_SIZES)
+{
+    double thresh = 0.5;
+    timeit::do_not_optimize(thresh);
+    bench_count(state, [thresh](auto first, auto last) {
+        return mystd::count_if(mystd::execution::par, first, last, mystd::LessThan(thresh));
+    });
+}
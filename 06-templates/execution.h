@@ -0,0 +1,123 @@
+// Execution policies of the mystd algorithms.
+//
+// The policies mirror those of std::execution, which libstdc++ implements
+// only with TBB: seq runs an algorithm as a serial loop, unseq allows the
+// elements to be visited out of order in vector lanes, and par splits a
+// random access range into chunks visited on separate threads.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace mystd {
+
+namespace execution {
+
+struct sequenced_policy {};
+struct unsequenced_policy {};
+struct parallel_policy
+{
+    unsigned num_threads = 0; // One per core when 0.
+};
+struct compensated_policy {};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr unsequenced_policy unseq{};
+inline constexpr parallel_policy par{};
+inline constexpr compensated_policy compensated{};
+
+}
+
+// _is_contiguous_iterator is true for iterators over elements stored in one
+// array, which the vectorized algorithms visit through a pointer.
+template <typename It, typename T = typename std::iterator_traits<It>::value_type>
+constexpr bool _is_contiguous_iterator =
+    !std::is_same_v<T, bool> &&
+    (std::is_pointer_v<It> ||
+     std::is_same_v<It, typename std::vector<T>::iterator> ||
+     std::is_same_v<It, typename std::vector<T>::const_iterator>);
+
+template <typename It>
+constexpr bool _is_random_access_iterator = std::is_base_of_v<
+    std::random_access_iterator_tag,
+    typename std::iterator_traits<It>::iterator_category>;
+
+// _parallel_grain is the least number of elements visited by a thread of par,
+// below which starting the thread costs more than the visits.
+constexpr std::size_t _parallel_grain = 1 << 16;
+
+// _num_chunks is the number of chunks par splits n elements into, one per
+// thread, 1 when the range is too short to be worth the threads.
+inline std::size_t _num_chunks(execution::parallel_policy policy, std::size_t n)
+{
+    if (n < 2 * _parallel_grain) {
+        return 1;
+    }
+    // hardware_concurrency is a system call, so ask once.
+    static const unsigned num_cores = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<std::size_t>(1, std::min<std::size_t>(
+        policy.num_threads != 0 ? policy.num_threads : num_cores,
+        n / _parallel_grain));
+}
+
+// _Join joins its threads when it goes out of scope, so that a failure to
+// start one does not leave the others joinable.
+struct _Join
+{
+    ~_Join()
+    {
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::vector<std::thread> threads;
+};
+
+// _for_each_chunk calls chunk(t, lo, hi) for each chunk t of num_chunks equal
+// chunks [lo, hi) of the indices [0, n), each on its own thread. An exception
+// thrown by a chunk is caught on its thread, and the first by chunk order is
+// rethrown once all the chunks are done.
+template <typename Chunk>
+void _for_each_chunk(std::size_t n, std::size_t num_chunks, Chunk chunk)
+{
+    std::vector<std::exception_ptr> errors(num_chunks);
+    auto visit = [&](std::size_t t) {
+        try {
+            chunk(t, n * t / num_chunks, n * (t + 1) / num_chunks);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    {
+        _Join join;
+        join.threads.reserve(num_chunks - 1);
+        for (std::size_t t = 1; t < num_chunks; ++t) {
+            join.threads.emplace_back(visit, t);
+        }
+        visit(0); // The calling thread visits the first chunk.
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+// _for_each_chunk calls chunk(t, lo, hi) for each chunk t of num_chunks equal
+// chunks of [first, last), each on its own thread.
+template <typename RandomIt, typename Chunk>
+void _for_each_chunk(RandomIt first, RandomIt last, std::size_t num_chunks, Chunk chunk)
+{
+    _for_each_chunk(std::distance(first, last), num_chunks,
+        [first, &chunk](std::size_t t, std::size_t lo, std::size_t hi) {
+            chunk(t, first + lo, first + hi);
+        });
+}
+
+}
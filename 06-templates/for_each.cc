@@ -1,43 +1,16 @@
 // Implement function template equivalent to std::for_each with UnaryFunction.
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <random>
+#include <stdexcept>
 #include <vector>
 
+#include "for_each.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Wrap in mystd to avoid collison with std::for_each.
-namespace mystd {
-
-// for_each calls UnaryFunction on each element in [first, last).
-// UnaryFunction will be implicitly moved.
-template <typename FwdIter, typename UnaryFunction>
-UnaryFunction
-for_each(FwdIter first, FwdIter last, UnaryFunction f)
-{
-    while (first != last) {
-        f(*first);
-        ++first;
-    }
-    return f;
-}
-
-// Avg computes the cumulative moving average (CMA) of the input.
-template <typename T>
-struct Avg
-{
-    void operator()(const T& x)
-    {
-        mu = (x + n*mu)/(n+1);
-        n += 1;
-    }
-
-    std::size_t n = 0;
-    double mu = 0.;
-};
-
-}
-
 TEST_CASE("[for_each]")
 {
     SUBCASE("for_each using functor")
@@ -68,3 +41,84 @@ TEST_CASE("[for_each]")
         REQUIRE(avg.mu == expected.mu);
     }
 }
+
+TEST_CASE("[for_each:par]")
+{
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 1.};
+    std::vector<double> v1(1'000'003);
+    for (auto& x : v1) {
+        x = 1e9 + dist(gen); // Large offset, variance 1/12.
+    }
+
+    SUBCASE("Avg is stable with a large offset")
+    {
+        auto avg = mystd::for_each(std::begin(v1), std::end(v1), mystd::Avg<double>{});
+        REQUIRE(avg.n == std::size(v1));
+        REQUIRE(std::abs(avg.mu - (1e9 + 0.5)) < 1e-3);
+        REQUIRE(std::abs(avg.variance() - 1. / 12) < 1e-3);
+    }
+
+    SUBCASE("Merge of Avg equals Avg of both")
+    {
+        std::vector<double> v2{1, 2, 3, 4, 5, 6, 7};
+        auto avg = mystd::for_each(std::begin(v2), std::end(v2), mystd::Avg<double>{});
+        for (std::size_t split = 0; split <= std::size(v2); ++split) {
+            auto lo = mystd::for_each(std::begin(v2), std::begin(v2) + split, mystd::Avg<double>{});
+            auto hi = mystd::for_each(std::begin(v2) + split, std::end(v2), mystd::Avg<double>{});
+            lo.merge(hi);
+            REQUIRE(lo.n == avg.n);
+            REQUIRE(std::abs(lo.mu - avg.mu) < 1e-12);
+            REQUIRE(std::abs(lo.variance() - avg.variance()) < 1e-12);
+        }
+        REQUIRE(avg.variance() == 14. / 3);
+    }
+
+    SUBCASE("Compare par to seq")
+    {
+        auto avg = mystd::for_each(mystd::execution::seq, std::begin(v1), std::end(v1),
+                                   mystd::Avg<double>{});
+        auto maxv = mystd::for_each(std::begin(v1), std::end(v1), mystd::Max<double>{});
+        REQUIRE(maxv.value == *std::max_element(std::begin(v1), std::end(v1)));
+        for (unsigned num_threads : {0, 2, 3, 16}) {
+            mystd::execution::parallel_policy par{num_threads};
+            auto pavg = mystd::for_each(par, std::begin(v1), std::end(v1), mystd::Avg<double>{});
+            REQUIRE(pavg.n == avg.n);
+            REQUIRE(std::abs(pavg.mu - avg.mu) < 1e-4); // 1e-13 of the mean.
+            REQUIRE(std::abs(pavg.variance() - avg.variance()) < 1e-6);
+            auto pmax = mystd::for_each(par, std::begin(v1), std::end(v1), mystd::Max<double>{});
+            REQUIRE(pmax.value == maxv.value);
+        }
+    }
+
+    SUBCASE("par with a merge for a lambda")
+    {
+        // Each copy of the lambda counts in its own captured count.
+        auto count = [n = std::size_t{0}](double) mutable { return ++n; };
+        for (unsigned num_threads : {2, 3}) {
+            std::size_t total = 0;
+            mystd::execution::parallel_policy par{num_threads};
+            auto merged = mystd::for_each(par, std::begin(v1), std::end(v1), count,
+                [&total](auto&, auto&& g) { total += g(0.) - 1; });
+            total += merged(0.) - 1;
+            REQUIRE(total == std::size(v1));
+        }
+    }
+
+    SUBCASE("par rethrows an exception of any chunk")
+    {
+        // The first and last elements are visited by the first and last
+        // chunks, on the calling thread and on another.
+        for (double bad : {v1.front(), v1.back()}) {
+            auto f = [bad](double x) {
+                if (x == bad) {
+                    throw std::runtime_error("bad");
+                }
+            };
+            mystd::execution::parallel_policy par{3};
+            REQUIRE_THROWS_AS(mystd::for_each(par, std::begin(v1), std::end(v1), f,
+                                              [](auto&, auto&&) {}),
+                              std::runtime_error);
+        }
+    }
+}
@@ -0,0 +1,167 @@
+// Function template equivalent to std::for_each with UnaryFunction.
+//
+// for_each returns the function it was given, so a functor such as Avg can
+// carry the state of its calls out of the loop. Under par, a random access
+// range is split into chunks visited on separate threads, each by its own
+// copy of the function, and the copies are then combined in order by a merge
+// into the function returned, as the partial results of a parallel reduction.
+// Avg is merged by the weighted mean of the copies and Max by their maximum.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "execution.h"
+
+// Wrap in mystd to avoid collison with std::for_each.
+namespace mystd {
+
+template<class>
+constexpr bool dependent_false = false;
+
+// for_each calls UnaryFunction on each element in [first, last).
+// UnaryFunction will be implicitly moved.
+template <typename FwdIter, typename UnaryFunction>
+UnaryFunction
+for_each(FwdIter first, FwdIter last, UnaryFunction f)
+{
+    while (first != last) {
+        f(*first);
+        ++first;
+    }
+    return f;
+}
+
+template <typename FwdIter, typename UnaryFunction>
+UnaryFunction
+for_each(execution::sequenced_policy, FwdIter first, FwdIter last, UnaryFunction f)
+{
+    return mystd::for_each(first, last, std::move(f));
+}
+
+// par visits the first chunk with f and each other chunk with a copy of f
+// as passed, so f should not yet hold the state of any element. Merge is
+// called as merge(f, g) to fold the function g of each later chunk into f.
+// State captured by reference is shared by all threads and needs its own
+// synchronization. If f throws in any chunk, the first exception by chunk
+// order is rethrown once every chunk is done.
+template <typename FwdIter, typename UnaryFunction, typename Merge>
+UnaryFunction
+for_each(execution::parallel_policy policy, FwdIter first, FwdIter last,
+         UnaryFunction f, Merge merge)
+{
+    if constexpr (!_is_random_access_iterator<FwdIter>) {
+        return mystd::for_each(first, last, std::move(f));
+    }
+    else {
+        std::size_t num_chunks = _num_chunks(policy, std::distance(first, last));
+        if (num_chunks == 1) {
+            return mystd::for_each(first, last, std::move(f));
+        }
+        // optional since lambdas may be copied but not assigned.
+        std::vector<std::optional<UnaryFunction>> fs(num_chunks);
+        for (std::size_t t = 1; t != num_chunks; ++t) {
+            fs[t].emplace(f);
+        }
+        fs[0].emplace(std::move(f));
+        _for_each_chunk(first, last, num_chunks,
+            [&fs](std::size_t t, FwdIter lo, FwdIter hi) {
+                fs[t].emplace(mystd::for_each(lo, hi, std::move(*fs[t])));
+            });
+        for (std::size_t t = 1; t != num_chunks; ++t) {
+            merge(*fs[0], std::move(*fs[t]));
+        }
+        return std::move(*fs[0]);
+    }
+}
+
+template <typename F, typename = void>
+struct _has_merge : std::false_type {};
+
+template <typename F>
+struct _has_merge<F, std::void_t<decltype(std::declval<F&>().merge(std::declval<F>()))>>
+    : std::true_type {};
+
+// par without a merge folds the copies of f with f.merge(g).
+template <typename FwdIter, typename UnaryFunction>
+UnaryFunction
+for_each(execution::parallel_policy policy, FwdIter first, FwdIter last, UnaryFunction f)
+{
+    if constexpr (_has_merge<UnaryFunction>::value) {
+        return mystd::for_each(policy, first, last, std::move(f),
+                               [](UnaryFunction& f, UnaryFunction&& g) {
+                                   f.merge(std::move(g));
+                               });
+    }
+    else {
+        static_assert(dependent_false<UnaryFunction>,
+                      "for_each(par) requires a merge or UnaryFunction::merge");
+    }
+}
+
+// Avg computes the mean and variance of the input with the update of
+// Welford, which adds to the mean the difference of x from it over the count
+// and accumulates the squared differences from the running mean. Unlike the
+// sum of squares less the square of the sum, the variance does not lose its
+// digits to cancellation when the input has a large offset.
+template <typename T>
+struct Avg
+{
+    void operator()(const T& x)
+    {
+        n += 1;
+        double delta = x - mu;
+        // The reciprocal does not depend on mu, so it is computed while the
+        // previous update is in flight.
+        mu += delta * (1. / n);
+        m2 += delta * (x - mu);
+    }
+
+    // merge combines the averages of two inputs into the average of both, as
+    // by Chan, Golub and LeVeque.
+    void merge(const Avg& other)
+    {
+        if (other.n == 0) {
+            return;
+        }
+        std::size_t total = n + other.n;
+        double delta = other.mu - mu;
+        mu += delta * other.n / total;
+        m2 += other.m2 + delta * delta * n / total * other.n;
+        n = total;
+    }
+
+    // variance is the sample variance of the input, 0 with fewer than 2.
+    double variance() const
+    {
+        return n > 1 ? m2 / (n - 1) : 0.;
+    }
+
+    std::size_t n = 0;
+    double mu = 0.;
+    double m2 = 0.; // Sum of squared differences from the mean.
+};
+
+// Max computes the maximum of the input, lowest of T when empty.
+template <typename T>
+struct Max
+{
+    void operator()(const T& x)
+    {
+        value = std::max(value, x);
+    }
+
+    void merge(const Max& other)
+    {
+        value = std::max(value, other.value);
+    }
+
+    T value = std::numeric_limits<T>::lowest();
+};
+
+}
@@ -0,0 +1,96 @@
+// Benchmark mystd::for_each with Avg and Max, serially and under par.
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "accumulate.h"
+#include "for_each.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Data is a range of samples with a large offset, as for timestamps, with
+// its mean and variance computed in two passes in long double.
+struct Data
+{
+    std::vector<double> values;
+    long double mean = 0;
+    long double variance = 0;
+};
+
+// make_data returns n samples.
+Data make_data(std::size_t n)
+{
+    Data d;
+    d.values.assign(n, 0.);
+    std::default_random_engine gen{};
+    std::uniform_real_distribution<double> dist{0., 1.};
+    for (auto& x : d.values) {
+        x = 1e9 + dist(gen);
+    }
+    d.mean = mystd::accumulate(mystd::execution::compensated,
+                               d.values.begin(), d.values.end(), 0.L) / n;
+    long double ss = 0;
+    for (auto x : d.values) {
+        ss += (x - d.mean) * (x - d.mean);
+    }
+    d.variance = ss / (n - 1);
+    return d;
+}
+
+template <typename ForEach>
+void bench_avg(timeit::State& state, ForEach for_each)
+{
+    auto d = make_data(state.arg());
+    mystd::Avg<double> avg;
+    while (state.keep_running()) {
+        avg = for_each(d.values.begin(), d.values.end(), mystd::Avg<double>{});
+        timeit::do_not_optimize(avg.mu);
+    }
+    state.counters["mean_error"] = static_cast<double>(std::abs((avg.mu - d.mean) / d.mean));
+    state.counters["variance_error"] = static_cast<double>(
+        std::abs((avg.variance() - d.variance) / d.variance));
+    state.set_items_processed(d.values.size());
+}
+
+template <typename ForEach>
+void bench_max(timeit::State& state, ForEach for_each)
+{
+    auto d = make_data(state.arg());
+    while (state.keep_running()) {
+        auto maxv = for_each(d.values.begin(), d.values.end(), mystd::Max<double>{});
+        timeit::do_not_optimize(maxv.value);
+    }
+    state.set_items_processed(d.values.size());
+}
+
+#define SAMPLE_SIZES 1'000, 1'000'000, 100'000'000
+
+TIMEIT_BENCHMARK_ARGS("[for_each:Avg]", SAMPLE_SIZES)
+{
+    bench_avg(state, [](auto first, auto last, auto f) {
+        return mystd::for_each(first, last, f);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[for_each:Avg:par]", SAMPLE_SIZES)
+{
+    bench_avg(state, [](auto first, auto last, auto f) {
+        return mystd::for_each(mystd::execution::par, first, last, f);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[for_each:Max]", SAMPLE_SIZES)
+{
+    bench_max(state, [](auto first, auto last, auto f) {
+        return mystd::for_each(first, last, f);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[for_each:Max:par]", SAMPLE_SIZES)
+{
+    bench_max(state, [](auto first, auto last, auto f) {
+        return mystd::for_each(mystd::execution::par, first, last, f);
+    });
+}
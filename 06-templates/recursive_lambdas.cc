@@ -1,5 +1,9 @@
 // Demonstrate methods for creating recursive lambda functions.
+#include <cstdint>
 #include <functional>
+#include <string>
+
+#include "recursive_lambdas.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
@@ -43,3 +47,74 @@ TEST_CASE("[recursive_lambda:function]")
     REQUIRE(factorial(1) == 1);
     REQUIRE(factorial(0) == 1);
 }
+
+TEST_CASE("[recursive_lambda:fix]")
+{
+    // fix passes the lambda to itself, so the lambda is called as any other
+    // function, without std::function. The return type must be explicit.
+    auto factorial = fix([](auto&& factorial, const int n) -> int {
+        if (n < 1) {
+            return 1;
+        }
+        return n * factorial(n - 1);
+    });
+
+    REQUIRE(factorial(5) == 120);
+    REQUIRE(factorial(4) == 24);
+    REQUIRE(factorial(0) == 1);
+
+    // Lambdas are constexpr, so is their fixed point.
+    constexpr auto fib = fix([](auto&& fib, const int n) -> int {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    });
+    static_assert(fib(20) == 6765);
+    REQUIRE(fib(10) == 55);
+}
+
+TEST_CASE("[recursive_lambda:memoize]")
+{
+    // Count the calls of the lambda, not of the memoized function.
+    int calls = 0;
+    auto fib = [&calls](auto&& fib, const int n) -> std::uint64_t {
+        ++calls;
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    };
+
+    SUBCASE("memoize in a hash table")
+    {
+        auto mfib = memoize<int, std::uint64_t>(fib);
+        REQUIRE(mfib(90) == 2880067194370816120ULL);
+        REQUIRE(calls == 91); // Once for each of 0 to 90.
+        REQUIRE(mfib(50) == 12586269025ULL);
+        REQUIRE(calls == 91);
+    }
+
+    SUBCASE("memoize in an array")
+    {
+        auto mfib = memoize<int, std::uint64_t>(fib, 91);
+        REQUIRE(mfib(90) == 2880067194370816120ULL);
+        REQUIRE(calls == 91);
+        // Keys outside the array are computed, but not remembered.
+        calls = 0;
+        REQUIRE(mfib(-1) == static_cast<std::uint64_t>(-1));
+        REQUIRE(mfib(-1) == static_cast<std::uint64_t>(-1));
+        REQUIRE(calls == 2);
+    }
+
+    SUBCASE("memoize with keys that are not integers")
+    {
+        // Length of the longest palindromic subsequence of a string.
+        auto lps = memoize<std::string, int>([](auto&& lps, const std::string& s) {
+            if (s.size() < 2) {
+                return static_cast<int>(s.size());
+            }
+            auto inner = s.substr(1, s.size() - 2);
+            if (s.front() == s.back()) {
+                return 2 + lps(inner);
+            }
+            return std::max(lps(s.substr(1)), lps(s.substr(0, s.size() - 1)));
+        });
+        REQUIRE(lps("character") == 5); // carac
+        REQUIRE(lps("") == 0);
+    }
+}
@@ -0,0 +1,153 @@
+// Recursive lambda functions without type erasure, with optional memoization.
+//
+// A lambda cannot name itself, so a recursive lambda either takes itself as
+// a parameter at every call, or captures a std::function of itself, whose
+// every recursion is an indirect call that the compiler cannot inline. fix,
+// the Y combinator, wraps a lambda taking itself as its first parameter into
+// a function that passes itself along, so that the lambda is called as any
+// other function and the recursion stays visible to the optimizer, and even
+// to constant evaluation. memoize does the same, but remembers the result for
+// each argument so that a recurrence with overlapping subproblems, such as
+// Fibonacci, is evaluated once per argument: in a FlatHashMap for any key, or
+// in an array for integer keys in a known range.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../11-containers/flat_hash_map.h"
+
+// Fix calls f with itself as the first argument.
+template <typename F>
+class Fix
+{
+public:
+    constexpr explicit Fix(F f)
+        : f(std::move(f))
+    { }
+
+    // The return type of f must be given explicitly, since that of a call
+    // is deduced from f, whose recursive calls cannot wait for it.
+    template <typename... Args>
+    constexpr decltype(auto) operator()(Args&&... args) const
+    {
+        return f(*this, std::forward<Args>(args)...);
+    }
+
+private:
+    F f;
+};
+
+// fix returns the fixed point of f, e.g.
+//   auto factorial = fix([](auto&& self, int n) -> int {
+//       return n < 1 ? 1 : n * self(n - 1);
+//   });
+template <typename F>
+constexpr Fix<std::decay_t<F>> fix(F&& f)
+{
+    return Fix<std::decay_t<F>>(std::forward<F>(f));
+}
+
+// _HashMemo remembers results by key in a FlatHashMap.
+template <typename Key, typename R>
+class _HashMemo
+{
+public:
+    const R* find(const Key& key) const
+    {
+        auto it = memo.find(key);
+        return it != memo.end() ? &it->second : nullptr;
+    }
+
+    void insert(const Key& key, const R& r)
+    {
+        memo.try_emplace(key, r);
+    }
+
+private:
+    FlatHashMap<Key, R> memo;
+};
+
+// _DenseMemo remembers results by key in an array indexed by keys in
+// [0, size), and nothing for other keys.
+template <typename Key, typename R>
+class _DenseMemo
+{
+public:
+    explicit _DenseMemo(std::size_t size)
+        : memo(size)
+    { }
+
+    const R* find(const Key& key) const
+    {
+        if (!in_range(key) || !memo[static_cast<std::size_t>(key)]) {
+            return nullptr;
+        }
+        return &*memo[static_cast<std::size_t>(key)];
+    }
+
+    void insert(const Key& key, const R& r)
+    {
+        if (in_range(key)) {
+            memo[static_cast<std::size_t>(key)].emplace(r);
+        }
+    }
+
+private:
+    bool in_range(const Key& key) const
+    {
+        if constexpr (std::is_signed_v<Key>) {
+            if (key < 0) {
+                return false;
+            }
+        }
+        return static_cast<std::size_t>(key) < memo.size();
+    }
+
+    std::vector<std::optional<R>> memo;
+};
+
+// Memoized calls f with itself as the first argument once for each key, and
+// thereafter returns the remembered result. It is not thread-safe.
+template <typename Key, typename R, typename F, typename Memo>
+class Memoized
+{
+public:
+    Memoized(F f, Memo memo)
+        : f(std::move(f)), memo(std::move(memo))
+    { }
+
+    // The result is returned by value since memo may move it on insert.
+    R operator()(const Key& key)
+    {
+        if (const R* r = memo.find(key)) {
+            return *r;
+        }
+        R r = f(*this, key);
+        memo.insert(key, r);
+        return r;
+    }
+
+private:
+    F f;
+    Memo memo;
+};
+
+// memoize returns f of Key to R memoized in a FlatHashMap.
+template <typename Key, typename R, typename F>
+Memoized<Key, R, std::decay_t<F>, _HashMemo<Key, R>> memoize(F&& f)
+{
+    return {std::forward<F>(f), _HashMemo<Key, R>{}};
+}
+
+// memoize returns f of integer Key to R memoized in an array for keys in
+// [0, size), which unlike a hash table needs no hashing nor probing.
+template <typename Key, typename R, typename F>
+Memoized<Key, R, std::decay_t<F>, _DenseMemo<Key, R>> memoize(F&& f, std::size_t size)
+{
+    static_assert(std::is_integral_v<Key>, "dense memoize requires integer keys");
+    return {std::forward<F>(f), _DenseMemo<Key, R>{size}};
+}
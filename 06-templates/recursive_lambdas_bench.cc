@@ -0,0 +1,89 @@
+// Benchmark recursive lambdas by self parameter, std::function, fix and memoize.
+#include <cstdint>
+#include <functional>
+
+#include "recursive_lambdas.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// fib_calls is the number of calls of the naive recursion for fib(n).
+inline double fib_calls(int n)
+{
+    double a = 1, b = 1; // Calls for fib(0) and fib(1).
+    for (int i = 1; i < n; ++i) {
+        double c = a + b + 1;
+        a = b;
+        b = c;
+    }
+    return n < 1 ? a : b;
+}
+
+#define FIB_SIZES 20, 25, 30
+
+TIMEIT_BENCHMARK_ARGS("[fib:auto]", FIB_SIZES)
+{
+    auto fib = [](const int n, auto&& fib) -> std::uint64_t {
+        return n < 2 ? n : fib(n - 1, fib) + fib(n - 2, fib);
+    };
+    int n = state.arg();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(n);
+        timeit::do_not_optimize(fib(n, fib));
+    }
+    state.set_items_processed(fib_calls(n));
+}
+
+TIMEIT_BENCHMARK_ARGS("[fib:function]", FIB_SIZES)
+{
+    std::function<std::uint64_t(const int)> fib = [&fib](const int n) -> std::uint64_t {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    };
+    int n = state.arg();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(n);
+        timeit::do_not_optimize(fib(n));
+    }
+    state.set_items_processed(fib_calls(n));
+}
+
+TIMEIT_BENCHMARK_ARGS("[fib:fix]", FIB_SIZES)
+{
+    auto fib = fix([](auto&& fib, const int n) -> std::uint64_t {
+        return n < 2 ? n : fib(n - 1) + fib(n - 2);
+    });
+    int n = state.arg();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(n);
+        timeit::do_not_optimize(fib(n));
+    }
+    state.set_items_processed(fib_calls(n));
+}
+
+// The memoized benchmarks start each iteration with an empty memo, and
+// evaluate the lambda n + 1 times instead of fib_calls(n).
+TIMEIT_BENCHMARK_ARGS("[fib:memoize:hash]", FIB_SIZES)
+{
+    int n = state.arg();
+    while (state.keep_running()) {
+        auto fib = memoize<int, std::uint64_t>([](auto&& fib, const int n) -> std::uint64_t {
+            return n < 2 ? n : fib(n - 1) + fib(n - 2);
+        });
+        timeit::do_not_optimize(n);
+        timeit::do_not_optimize(fib(n));
+    }
+    state.set_items_processed(n + 1);
+}
+
+TIMEIT_BENCHMARK_ARGS("[fib:memoize:dense]", FIB_SIZES)
+{
+    int n = state.arg();
+    while (state.keep_running()) {
+        auto fib = memoize<int, std::uint64_t>([](auto&& fib, const int n) -> std::uint64_t {
+            return n < 2 ? n : fib(n - 1) + fib(n - 2);
+        }, n + 1);
+        timeit::do_not_optimize(n);
+        timeit::do_not_optimize(fib(n));
+    }
+    state.set_items_processed(n + 1);
+}
@@ -0,0 +1,98 @@
+// Demonstrate finding and replacing many patterns in one pass.
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ahocorasick.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using Matches = std::vector<AcMatch>;
+
+TEST_CASE("[AhoCorasick::matches]")
+{
+    SUBCASE("overlapping matches in order of end")
+    {
+        // Classic example from Aho and Corasick.
+        AhoCorasick ac{{"he", "she", "his", "hers"}};
+        REQUIRE(ac.matches("ushers") == Matches{{1, 3, 1}, {2, 2, 0}, {2, 4, 3}});
+        REQUIRE(ac.matches("ahishers") ==
+                Matches{{1, 3, 2}, {3, 3, 1}, {4, 2, 0}, {4, 4, 3}});
+    }
+
+    SUBCASE("no matches")
+    {
+        AhoCorasick ac{{"abc", "xyz"}};
+        REQUIRE(ac.matches("").empty());
+        REQUIRE(ac.matches("ab xy bc yz").empty());
+    }
+
+    SUBCASE("matches past the SIMD prefilter")
+    {
+        // Long runs of bytes that start no pattern around each match.
+        std::string text = std::string(100, '.') + "needle" + std::string(37, '.') + "pin";
+        AhoCorasick ac{{"needle", "pin"}};
+        REQUIRE(ac.matches(text) == Matches{{100, 6, 0}, {143, 3, 1}});
+    }
+
+    SUBCASE("more first bytes than the SIMD prefilter")
+    {
+        std::vector<std::string> patterns;
+        for (char c = 'a'; c <= 'p'; ++c) {
+            patterns.push_back(std::string{c, '!'});
+        }
+        AhoCorasick ac{patterns};
+        REQUIRE(ac.matches("zzzz p! zzzzz a!") == Matches{{5, 2, 15}, {14, 2, 0}});
+    }
+
+    SUBCASE("empty pattern")
+    {
+        REQUIRE_THROWS_AS(AhoCorasick({"a", ""}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("[AhoCorasick::for_each_leftmost]")
+{
+    AhoCorasick ac{{"abcd", "bc", "b", "cde"}};
+    Matches rcv;
+    ac.for_each_leftmost("xabcdebcde", [&rcv](const AcMatch& m) { rcv.push_back(m); });
+    // abcd wins over the bc that ends first, then bc over b, and the cde
+    // that overlaps bc is skipped.
+    REQUIRE(rcv == Matches{{1, 4, 0}, {6, 2, 1}});
+}
+
+TEST_CASE("[AhoCorasick::replace]")
+{
+    AhoCorasick ac{{"alice", "bob", "555-1234"}};
+    std::vector<std::string> redacted{"[name]", "[name]", "[phone]"};
+
+    std::string out;
+    ac.replace("call alice or bob at 555-1234.", redacted, out);
+    REQUIRE(out == "call [name] or [name] at [phone].");
+
+    // Output is appended to.
+    ac.replace(" no pii", redacted, out);
+    REQUIRE(out == "call [name] or [name] at [phone]. no pii");
+
+    REQUIRE_THROWS_AS(ac.replace("bob", {"[name]"}, out), std::invalid_argument);
+}
+
+TEST_CASE("[AhoCorasick::Stream]")
+{
+    AhoCorasick ac{{"needle", "pin"}};
+    std::string text = "a needle and a pin and a needle";
+    auto expected = ac.matches(text);
+
+    // Split at every position, so that matches straddle the chunks.
+    for (std::size_t split = 0; split <= text.size(); ++split) {
+        AhoCorasick::Stream stream{ac};
+        Matches rcv;
+        auto append = [&rcv](const AcMatch& m) { rcv.push_back(m); };
+        stream.feed(std::string_view{text}.substr(0, split), append);
+        stream.feed(std::string_view{text}.substr(split), append);
+        CAPTURE(split);
+        REQUIRE(rcv == expected);
+    }
+}
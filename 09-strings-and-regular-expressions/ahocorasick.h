@@ -0,0 +1,329 @@
+// Find many literal patterns in one pass with an Aho-Corasick automaton.
+//
+// The trie of the patterns is completed into a DFA over all 256 bytes using
+// the failure links, so each byte of input costs one table lookup. Bytes that
+// no state tells apart share a column of the table to keep it in cache. While
+// the automaton is in its root state no pattern is in progress, and the input
+// is skipped with SIMD compares to the next byte that begins a pattern.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// AcMatch is an occurrence of patterns[pattern] at text[start, start + length).
+struct AcMatch
+{
+    std::size_t start;
+    std::size_t length;
+    std::size_t pattern;
+
+    bool operator==(const AcMatch& rhs) const
+    {
+        return start == rhs.start && length == rhs.length && pattern == rhs.pattern;
+    }
+};
+
+class AhoCorasick
+{
+public:
+    // Patterns must be non-empty, else std::invalid_argument is thrown.
+    explicit AhoCorasick(const std::vector<std::string>& patterns)
+        : lengths(patterns.size())
+    {
+        build(patterns);
+    }
+
+    // for_each_match calls func(match) for every occurrence of every pattern
+    // in text, including overlapping ones, in order of their end.
+    template <typename Func>
+    void for_each_match(std::string_view text, Func func) const
+    {
+        std::int32_t state = root;
+        scan(text, state, 0, func);
+    }
+
+    // matches returns all the occurrences of for_each_match.
+    std::vector<AcMatch> matches(std::string_view text) const
+    {
+        std::vector<AcMatch> results;
+        for_each_match(text, [&results](const AcMatch& m) { results.push_back(m); });
+        return results;
+    }
+
+    // for_each_leftmost calls func(match) for non-overlapping occurrences from
+    // left to right, choosing the longest pattern among those that start at
+    // the leftmost position.
+    template <typename Func>
+    void for_each_leftmost(std::string_view text, Func func) const
+    {
+        const std::size_t n = text.size();
+        std::size_t i = 0;
+        while (i < n) {
+            std::int32_t s = root;
+            bool found = false;
+            AcMatch best{};
+            for (; i < n; ++i) {
+                if (s == root) {
+                    if (found) {
+                        break;
+                    }
+                    i = skip(text.data(), i, n);
+                    if (i == n) {
+                        break;
+                    }
+                }
+                s = next(s, text[i]);
+                for (auto k = out_begin[s]; k != out_begin[s + 1]; ++k) {
+                    std::size_t p = out_ids[k];
+                    AcMatch m{i + 1 - lengths[p], lengths[p], p};
+                    if (!found || m.start < best.start ||
+                        (m.start == best.start && m.length > best.length)) {
+                        best = m;
+                        found = true;
+                    }
+                }
+                // Stop once no pattern in progress can start at or before best.
+                if (found && i + 1 - depth[s] > best.start) {
+                    break;
+                }
+            }
+            if (!found) {
+                break;
+            }
+            func(best);
+            i = best.start + best.length;
+        }
+    }
+
+    // replace appends text to out with each leftmost occurrence of patterns[i]
+    // replaced by replacements[i]. Apart from growing out, it does not allocate.
+    void replace(std::string_view text, const std::vector<std::string>& replacements,
+                 std::string& out) const
+    {
+        if (replacements.size() != lengths.size()) {
+            throw std::invalid_argument{"aho-corasick: one replacement per pattern"};
+        }
+        std::size_t copied = 0;
+        for_each_leftmost(text, [&](const AcMatch& m) {
+            out.append(text.data() + copied, m.start - copied);
+            out.append(replacements[m.pattern]);
+            copied = m.start + m.length;
+        });
+        out.append(text.data() + copied, text.size() - copied);
+    }
+
+    // Stream finds the occurrences of the patterns in text that arrives in
+    // chunks, including occurrences that straddle two chunks. Match start is
+    // the offset from the beginning of the stream.
+    class Stream
+    {
+    public:
+        explicit Stream(const AhoCorasick& ac) : ac{ac} {}
+
+        // feed calls func(match) for every occurrence that ends in chunk.
+        template <typename Func>
+        void feed(std::string_view chunk, Func func)
+        {
+            ac.scan(chunk, state, offset, func);
+            offset += chunk.size();
+        }
+
+    private:
+        const AhoCorasick& ac;
+        std::int32_t state = root;
+        std::size_t offset = 0;
+    };
+
+    // states returns the number of states of the automaton.
+    std::size_t states() const { return depth.size(); }
+
+private:
+    static constexpr std::int32_t root = 0;
+    // The prefilter compares up to this many distinct first bytes with SIMD.
+    static constexpr std::size_t max_simd_starts = 8;
+
+    void build(const std::vector<std::string>& patterns)
+    {
+        // Trie, where a transition to root means no edge.
+        for (int c = 0; c != 256; ++c) {
+            classes[c] = static_cast<std::uint8_t>(c);
+        }
+        add_state(0);
+        std::vector<std::vector<std::size_t>> outputs(1);
+        for (std::size_t p = 0; p != patterns.size(); ++p) {
+            if (patterns[p].empty()) {
+                throw std::invalid_argument{"aho-corasick: empty pattern"};
+            }
+            lengths[p] = patterns[p].size();
+            std::int32_t s = root;
+            for (char c : patterns[p]) {
+                if (next(s, c) == root) {
+                    std::int32_t t = add_state(depth[s] + 1); // Resizes delta.
+                    delta[index(s, c)] = t;
+                    outputs.emplace_back();
+                }
+                s = next(s, c);
+            }
+            outputs[s].push_back(p);
+        }
+
+        // Complete the trie into a DFA in breadth first order, so the failure
+        // state of each state is complete before the state itself. Missing
+        // edges take the edge of the failure state, and outputs include the
+        // outputs of the failure state.
+        std::vector<std::int32_t> fail(depth.size(), root);
+        std::queue<std::int32_t> q;
+        for (int c = 0; c != 256; ++c) {
+            if (delta[c] != root) {
+                q.push(delta[c]);
+            }
+        }
+        while (!q.empty()) {
+            std::int32_t s = q.front();
+            q.pop();
+            const auto& inherited = outputs[fail[s]];
+            outputs[s].insert(outputs[s].end(), inherited.begin(), inherited.end());
+            for (int c = 0; c != 256; ++c) {
+                auto& t = delta[s * 256 + c];
+                std::int32_t f = delta[fail[s] * 256 + c];
+                if (t == root) {
+                    t = f;
+                } else {
+                    fail[t] = f;
+                    q.push(t);
+                }
+            }
+        }
+
+        // Flatten the outputs so reporting a match touches one array.
+        out_begin.push_back(0);
+        for (const auto& o : outputs) {
+            out_ids.insert(out_ids.end(), o.begin(), o.end());
+            out_begin.push_back(out_ids.size());
+        }
+
+        for (int c = 0; c != 256; ++c) {
+            first[c] = delta[c] != root;
+            if (first[c]) {
+                starts.push_back(static_cast<char>(c));
+            }
+        }
+
+        // Bytes with the same transition from every state share a class.
+        std::map<std::vector<std::int32_t>, std::size_t> columns;
+        std::vector<std::int32_t> column(depth.size());
+        for (int c = 0; c != 256; ++c) {
+            for (std::size_t s = 0; s != depth.size(); ++s) {
+                column[s] = delta[s * 256 + c];
+            }
+            classes[c] = static_cast<std::uint8_t>(
+                columns.emplace(column, columns.size()).first->second);
+        }
+        nclasses = columns.size();
+        std::vector<std::int32_t> table(depth.size() * nclasses);
+        for (int c = 0; c != 256; ++c) {
+            for (std::size_t s = 0; s != depth.size(); ++s) {
+                table[s * nclasses + classes[c]] = delta[s * 256 + c];
+            }
+        }
+        delta = std::move(table);
+    }
+
+    std::int32_t add_state(std::int32_t d)
+    {
+        depth.push_back(d);
+        delta.resize(delta.size() + 256, root);
+        return static_cast<std::int32_t>(depth.size()) - 1;
+    }
+
+    std::size_t index(std::int32_t s, char c) const
+    {
+        return static_cast<std::size_t>(s) * nclasses + classes[static_cast<unsigned char>(c)];
+    }
+
+    std::int32_t next(std::int32_t s, char c) const
+    {
+        return delta[index(s, c)];
+    }
+
+    // scan runs the automaton from state over text, reporting matches with
+    // start relative to offset, and leaves state where text ended.
+    template <typename Func>
+    void scan(std::string_view text, std::int32_t& state, std::size_t offset, Func& func) const
+    {
+        const std::size_t n = text.size();
+        std::int32_t s = state;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (s == root) {
+                i = skip(text.data(), i, n);
+                if (i == n) {
+                    break;
+                }
+            }
+            s = next(s, text[i]);
+            for (auto k = out_begin[s]; k != out_begin[s + 1]; ++k) {
+                std::size_t p = out_ids[k];
+                func(AcMatch{offset + i + 1 - lengths[p], lengths[p], p});
+            }
+        }
+        state = s;
+    }
+
+    // skip returns the first position from i where a pattern may begin.
+    std::size_t skip(const char* p, std::size_t i, std::size_t n) const
+    {
+#if defined(__AVX2__)
+        if (starts.size() <= max_simd_starts) {
+            for (; i + 32 <= n; i += 32) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                __m256i eq = _mm256_setzero_si256();
+                for (char c : starts) {
+                    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)));
+                }
+                auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+        }
+#elif defined(__SSE2__)
+        if (starts.size() <= max_simd_starts) {
+            for (; i + 16 <= n; i += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                __m128i eq = _mm_setzero_si128();
+                for (char c : starts) {
+                    eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+                }
+                auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+        }
+#endif
+        while (i < n && !first[static_cast<unsigned char>(p[i])]) {
+            ++i;
+        }
+        return i;
+    }
+
+    std::vector<std::size_t> lengths;     // Length of each pattern.
+    std::uint8_t classes[256];            // Column of each byte.
+    std::size_t nclasses = 256;
+    std::vector<std::int32_t> delta;      // nclasses transitions per state.
+    std::vector<std::int32_t> depth;      // Length of the prefix of each state.
+    std::vector<std::size_t> out_begin;   // Outputs of s are out_ids[out_begin[s], out_begin[s+1]).
+    std::vector<std::size_t> out_ids;
+    std::vector<char> starts;             // Distinct first bytes of the patterns.
+    bool first[256] = {};
+};
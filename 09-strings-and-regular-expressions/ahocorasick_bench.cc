@@ -0,0 +1,136 @@
+// Benchmark redacting many patterns in one pass against one pass per pattern.
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ahocorasick.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_patterns returns npatterns names and phone numbers to be redacted.
+std::vector<std::string> make_patterns(std::size_t npatterns)
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<int> digit{'0', '9'};
+    std::vector<std::string> patterns;
+    for (std::size_t p = 0; p != npatterns; ++p) {
+        std::string s;
+        if (p % 2 == 0) {
+            for (int i = 0; i != 6; ++i) {
+                s += static_cast<char>(letter(gen));
+            }
+        } else {
+            for (int i = 0; i != 8; ++i) {
+                s += i == 3 ? '-' : static_cast<char>(digit(gen));
+            }
+        }
+        patterns.push_back(s);
+    }
+    return patterns;
+}
+
+// make_records returns nbytes of records of words where about one word in 20
+// is one of patterns.
+std::string make_records(std::int64_t nbytes, const std::vector<std::string>& patterns)
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> letter{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> pick{0, 20 * patterns.size() - 1};
+    std::string text;
+    while (static_cast<std::int64_t>(text.size()) < nbytes) {
+        for (int w = 0; w != 10; ++w) {
+            std::size_t p = pick(gen);
+            if (p < patterns.size()) {
+                text += patterns[p];
+            } else {
+                for (std::size_t i = 0; i != 3 + p % 6; ++i) {
+                    text += static_cast<char>(letter(gen));
+                }
+            }
+            text += w == 9 ? '\n' : ' ';
+        }
+    }
+    return text;
+}
+
+constexpr std::int64_t nbytes = 1 << 22;
+
+// Each pattern is replaced by a pass of std::string::find over the text.
+TIMEIT_BENCHMARK_ARGS("[redact:find]", 4, 32)
+{
+    auto patterns = make_patterns(state.arg());
+    auto text = make_records(nbytes, patterns);
+    while (state.keep_running()) {
+        std::string s = text, out;
+        for (const auto& p : patterns) {
+            out.clear();
+            std::size_t copied = 0;
+            for (auto pos = s.find(p); pos != std::string::npos; pos = s.find(p, copied)) {
+                out.append(s, copied, pos - copied).append("[pii]");
+                copied = pos + p.size();
+            }
+            out.append(s, copied);
+            std::swap(s, out);
+        }
+        timeit::do_not_optimize(s);
+    }
+    state.set_bytes_processed(text.size());
+}
+
+// All the patterns are replaced by one std::regex alternation.
+TIMEIT_BENCHMARK_ARGS("[redact:regex_replace]", 4, 32)
+{
+    auto patterns = make_patterns(state.arg());
+    auto text = make_records(nbytes, patterns);
+    std::string alternation;
+    for (const auto& p : patterns) {
+        alternation += (alternation.empty() ? "" : "|") + p;
+    }
+    std::regex pat{alternation};
+    while (state.keep_running()) {
+        std::string s;
+        std::regex_replace(std::back_inserter(s), text.begin(), text.end(), pat, "[pii]");
+        timeit::do_not_optimize(s);
+    }
+    state.set_bytes_processed(text.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[redact:AhoCorasick::replace]", 4, 32, 256)
+{
+    auto patterns = make_patterns(state.arg());
+    auto text = make_records(nbytes, patterns);
+    AhoCorasick ac{patterns};
+    std::vector<std::string> redacted(patterns.size(), "[pii]");
+    std::string s;
+    while (state.keep_running()) {
+        s.clear(); // Reuse the capacity of the output buffer.
+        ac.replace(text, redacted, s);
+        timeit::do_not_optimize(s);
+    }
+    state.set_bytes_processed(text.size());
+}
+
+// Count matches reading the text in 64KB chunks.
+TIMEIT_BENCHMARK_ARGS("[redact:AhoCorasick::Stream]", 4, 32, 256)
+{
+    auto patterns = make_patterns(state.arg());
+    auto text = make_records(nbytes, patterns);
+    AhoCorasick ac{patterns};
+    while (state.keep_running()) {
+        AhoCorasick::Stream stream{ac};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < text.size(); i += 1 << 16) {
+            stream.feed(std::string_view{text}.substr(i, 1 << 16),
+                        [&n](const AcMatch&) { ++n; });
+        }
+        timeit::do_not_optimize(n);
+    }
+    state.set_bytes_processed(text.size());
+}
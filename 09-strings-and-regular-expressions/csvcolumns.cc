@@ -0,0 +1,116 @@
+// Demonstrate parsing csv in parallel into typed columns.
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csvcolumns.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using Ints = std::vector<std::int64_t>;
+using Doubles = std::vector<double>;
+using Strings = std::vector<std::string_view>;
+
+const std::vector<ColumnType> schema{ColumnType::int64,
+                                     ColumnType::float64,
+                                     ColumnType::string};
+
+TEST_CASE("[csv_chunk_bounds]")
+{
+    SUBCASE("boundaries follow a newline")
+    {
+        std::string csv;
+        for (int i = 0; i != 1000; ++i) {
+            csv += std::to_string(i) + ",x\n";
+        }
+        auto bounds = csv_chunk_bounds(csv, 4);
+        REQUIRE(bounds.size() == 5);
+        REQUIRE(bounds.front() == 0);
+        REQUIRE(bounds.back() == csv.size());
+        for (std::size_t i = 1; i != 4; ++i) {
+            REQUIRE(bounds[i] >= bounds[i - 1]);
+            REQUIRE(csv[bounds[i] - 1] == '\n');
+        }
+    }
+
+    SUBCASE("newlines inside quotes are skipped")
+    {
+        // The raw split point falls inside a quoted field with newlines.
+        std::string csv = "1,\"" + std::string(100, '\n') + "\"\n2,x\n";
+        auto bounds = csv_chunk_bounds(csv, 2);
+        REQUIRE(bounds[1] == csv.find("2,x"));
+    }
+
+    SUBCASE("single chunk")
+    {
+        std::string csv = "1,x\n";
+        REQUIRE(csv_chunk_bounds(csv, 1) == std::vector<std::size_t>{0, csv.size()});
+    }
+
+    SUBCASE("more chunks than bytes")
+    {
+        std::string csv = "\"\n\"\n2\n";
+        auto bounds = csv_chunk_bounds(csv, 16);
+        REQUIRE(bounds.size() == 17);
+        REQUIRE(bounds.front() == 0);
+        for (std::size_t i = 1; i != bounds.size(); ++i) {
+            REQUIRE(bounds[i] >= bounds[i - 1]);
+            REQUIRE((bounds[i] == 4 || bounds[i] == csv.size()));
+        }
+        REQUIRE(csv_chunk_bounds("", 4) == std::vector<std::size_t>(5, 0));
+    }
+}
+
+TEST_CASE("[csv_read_columns]")
+{
+    SUBCASE("typed columns")
+    {
+        auto columns = csv_read_columns("1,0.5,one\n-2,1e3,\"t,w,o\"\n", schema);
+        REQUIRE(columns.size() == 3);
+        REQUIRE(std::get<Ints>(columns[0]) == Ints{1, -2});
+        REQUIRE(std::get<Doubles>(columns[1]) == Doubles{0.5, 1000.});
+        REQUIRE(std::get<Strings>(columns[2]) == Strings{"one", "t,w,o"});
+    }
+
+    SUBCASE("header, delimiter and blank lines")
+    {
+        CsvOptions opts;
+        opts.delim = ';';
+        opts.header = true;
+        auto columns = csv_read_columns("id;value;name\n\n7;2.5;seven\r\n", schema, opts);
+        REQUIRE(std::get<Ints>(columns[0]) == Ints{7});
+        REQUIRE(std::get<Doubles>(columns[1]) == Doubles{2.5});
+        REQUIRE(std::get<Strings>(columns[2]) == Strings{"seven"});
+    }
+
+    SUBCASE("invalid records")
+    {
+        REQUIRE_THROWS_AS(csv_read_columns("x,1,one\n", schema), std::runtime_error);
+        REQUIRE_THROWS_AS(csv_read_columns("1,1.5x,one\n", schema), std::runtime_error);
+        REQUIRE_THROWS_AS(csv_read_columns("1,1\n", schema), std::runtime_error);
+        REQUIRE_THROWS_AS(csv_read_columns("1,1,one,two\n", schema), std::runtime_error);
+    }
+
+    SUBCASE("parallel matches sequential")
+    {
+        // Large enough to split into several chunks, with quoted newlines.
+        std::string csv;
+        for (int i = 0; i != 100'000; ++i) {
+            csv += std::to_string(i) + "," + std::to_string(i) + ".5,";
+            csv += i % 3 == 0 ? "\"multi\nline\"\n" : "word\n";
+        }
+        CsvOptions seq;
+        seq.nthreads = 1;
+        CsvOptions par;
+        par.nthreads = 8;
+        auto expected = csv_read_columns(csv, schema, seq);
+        auto actual = csv_read_columns(csv, schema, par);
+        REQUIRE(std::get<Ints>(expected[0]).size() == 100'000);
+        REQUIRE(std::get<Ints>(actual[0]) == std::get<Ints>(expected[0]));
+        REQUIRE(std::get<Doubles>(actual[1]) == std::get<Doubles>(expected[1]));
+        REQUIRE(std::get<Strings>(actual[2]) == std::get<Strings>(expected[2]));
+    }
+}
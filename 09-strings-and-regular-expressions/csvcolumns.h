@@ -0,0 +1,195 @@
+// Parse csv in parallel into typed columns without intermediate strings.
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "csvscan.h"
+
+enum class ColumnType { int64, float64, string };
+
+// Column holds the values of one field of every record. Strings are views
+// into the csv text with quotes removed but "" escapes intact.
+using Column = std::variant<std::vector<std::int64_t>,
+                            std::vector<double>,
+                            std::vector<std::string_view>>;
+
+struct CsvOptions
+{
+    char delim = ',';
+    bool header = false;  // Skip the first record.
+    std::size_t nthreads = std::max(1U, std::thread::hardware_concurrency());
+};
+
+// _parse_field converts field with std::from_chars and appends it to column.
+inline void _parse_field(std::string_view field, Column& column)
+{
+    std::visit([field](auto& values) {
+        using T = typename std::decay_t<decltype(values)>::value_type;
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            values.push_back(field);
+        } else {
+            T value{};
+            auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+            if (ec != std::errc() || ptr != field.data() + field.size()) {
+                throw std::runtime_error{"csv: invalid number: " + std::string{field}};
+            }
+            values.push_back(value);
+        }
+    }, column);
+}
+
+// _make_columns returns one empty column per entry of schema.
+inline std::vector<Column> _make_columns(const std::vector<ColumnType>& schema)
+{
+    std::vector<Column> columns;
+    for (auto type : schema) {
+        switch (type) {
+        case ColumnType::int64:   columns.emplace_back(std::vector<std::int64_t>{}); break;
+        case ColumnType::float64: columns.emplace_back(std::vector<double>{}); break;
+        case ColumnType::string:  columns.emplace_back(std::vector<std::string_view>{}); break;
+        }
+    }
+    return columns;
+}
+
+// csv_parse_columns parses the complete records of text into columns.
+// Blank lines are skipped.
+inline void csv_parse_columns(std::string_view text, std::vector<Column>& columns, char delim)
+{
+    std::size_t col = 0;
+    csv_for_each_field(text, [&](std::string_view field, bool end_of_record) {
+        if (col == 0 && end_of_record && field.empty()) {
+            return;
+        }
+        if (col == columns.size()) {
+            throw std::runtime_error{"csv: too many fields in record"};
+        }
+        _parse_field(field, columns[col++]);
+        if (end_of_record) {
+            if (col != columns.size()) {
+                throw std::runtime_error{"csv: too few fields in record"};
+            }
+            col = 0;
+        }
+    }, delim);
+}
+
+// csv_chunk_bounds splits text into nchunks byte ranges that each begin at the
+// start of a record. A newline only ends a record outside quotes, so the quote
+// parity at each raw split point is found from the quote counts of the
+// preceding ranges, counted in parallel, before scanning to the next newline.
+inline std::vector<std::size_t> csv_chunk_bounds(std::string_view text, std::size_t nchunks)
+{
+    std::vector<std::size_t> bounds(nchunks + 1, text.size());
+    bounds[0] = 0;
+    // Split at most once per byte, so that every split point but the first is
+    // past the start of text. The chunks beyond are empty.
+    nchunks = std::min(nchunks, text.size());
+    if (nchunks < 2) {
+        return bounds;
+    }
+
+    std::vector<std::size_t> quotes(nchunks);
+    auto raw = [&text, nchunks](std::size_t i) { return text.size() * i / nchunks; };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i != nchunks; ++i) {
+        workers.emplace_back([&, i] {
+            quotes[i] = std::count(text.begin() + raw(i), text.begin() + raw(i + 1), '"');
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    std::size_t parity = 0;
+    for (std::size_t i = 1; i != nchunks; ++i) {
+        parity += quotes[i - 1];
+        bool inside = parity % 2;
+        std::size_t b = raw(i);
+        while (b < text.size() && (inside || text[b - 1] != '\n')) {
+            inside ^= text[b] == '"';
+            ++b;
+        }
+        bounds[i] = std::max(b, bounds[i - 1]);
+    }
+    return bounds;
+}
+
+// csv_read_columns parses text into one column per schema entry using
+// opts.nthreads threads. Each thread parses the records of one chunk into its
+// own columns, which are then concatenated. Throws std::runtime_error when a
+// record does not match schema. The string columns are views into text.
+inline std::vector<Column>
+csv_read_columns(std::string_view text, const std::vector<ColumnType>& schema,
+                 const CsvOptions& opts = {})
+{
+    if (opts.header) {
+        std::size_t skip = 0;
+        bool inside = false;
+        while (skip < text.size() && (inside || text[skip] != '\n')) {
+            inside ^= text[skip] == '"';
+            ++skip;
+        }
+        text.remove_prefix(std::min(skip + 1, text.size()));
+    }
+
+    // Chunks smaller than this are not worth the cost of a thread.
+    constexpr std::size_t min_chunk = 1 << 16;
+    std::size_t nchunks = std::max<std::size_t>(1, std::min(opts.nthreads, text.size() / min_chunk));
+    auto bounds = csv_chunk_bounds(text, nchunks);
+
+    std::vector<std::vector<Column>> parts(nchunks, _make_columns(schema));
+    std::vector<std::exception_ptr> errors(nchunks);
+    auto parse_chunk = [&](std::size_t i) {
+        try {
+            csv_parse_columns(text.substr(bounds[i], bounds[i + 1] - bounds[i]),
+                              parts[i], opts.delim);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < nchunks; ++i) {
+        workers.emplace_back(parse_chunk, i);
+    }
+    parse_chunk(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+    for (auto& e : errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+
+    // Concatenate the chunk columns in order.
+    auto columns = std::move(parts[0]);
+    for (std::size_t c = 0; c != columns.size(); ++c) {
+        std::visit([&parts, c, nchunks](auto& values) {
+            using V = std::decay_t<decltype(values)>;
+            std::size_t total = values.size();
+            for (std::size_t i = 1; i < nchunks; ++i) {
+                total += std::get<V>(parts[i][c]).size();
+            }
+            values.reserve(total);
+            for (std::size_t i = 1; i < nchunks; ++i) {
+                const auto& part = std::get<V>(parts[i][c]);
+                values.insert(values.end(), part.begin(), part.end());
+            }
+        }, columns[c]);
+    }
+    return columns;
+}
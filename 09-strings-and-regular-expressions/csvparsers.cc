@@ -1,11 +1,11 @@
 // All the different ways to parse a csv.
-#include <algorithm>
-#include <iterator>
 #include <regex>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "csvparsers.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
@@ -15,10 +15,7 @@ TEST_CASE("[getline]")
     char delim{','};
 
     // Use std::getline to parse from istream based on delimiter.
-    std::vector<std::string> tokens;
-    for (std::string tok; std::getline(is, tok, delim);) {
-        tokens.push_back(tok);
-    }
+    auto tokens = split_getline(is, delim);
 
     REQUIRE(tokens ==
             std::vector<std::string>{"one","two","three","four","five"});
@@ -29,10 +26,7 @@ TEST_CASE("[istream_iterator]")
     // NOTE(mmorais): Works only with whitespace delimiter.
     std::istringstream is("one two three four five");
 
-    std::vector<std::string> tokens;
-    std::copy(std::istream_iterator<std::string>{is},
-              std::istream_iterator<std::string>{},
-              std::back_inserter(tokens));
+    auto tokens = split_istream_iterator(is);
 
     REQUIRE(tokens ==
             std::vector<std::string>{"one","two","three","four","five"});
@@ -44,14 +38,7 @@ TEST_CASE("[find_first_of]")
     std::string s{"one,two,three,four,five"};
     char delim{','};
 
-    std::vector<std::string> tokens;
-    std::size_t start = 0, end = s.find_first_of(delim);
-    while (end != std::string::npos) {
-        tokens.emplace_back(s.substr(start, end-start));
-        start = end + 1;
-        end = s.find_first_of(delim, start);
-    }
-    tokens.emplace_back(s.substr(start));
+    auto tokens = split_find_first_of(s, delim);
 
     REQUIRE(tokens ==
             std::vector<std::string>{"one","two","three","four","five"});
@@ -64,13 +51,22 @@ TEST_CASE("[sregex_token_iterator]")
     std::string s{"one ,  two ,  three ,  four , five"};
     std::regex delim{R"([\s,]+)"};
 
-    std::vector<std::string> tokens;
-    std::copy(std::sregex_token_iterator{std::begin(s), std::end(s),
-                                         delim,
-                                         -1}, // -1 return stuff btwn matches.
-              std::sregex_token_iterator{},
-              std::back_inserter(tokens));
+    auto tokens = split_sregex_token_iterator(s, delim);
 
     REQUIRE(tokens ==
             std::vector<std::string>{"one","two","three","four","five"});
 }
+
+TEST_CASE("[multiple lines]")
+{
+    std::string s{"one,two\nthree,four,five\n"};
+    std::vector<std::string> expected{"one","two","three","four","five"};
+
+    std::istringstream is1{s};
+    REQUIRE(split_getline(is1, ',') == expected);
+
+    REQUIRE(split_find_first_of(s, ',') == expected);
+
+    std::regex delim{R"([\s,]+)"};
+    REQUIRE(split_sregex_token_iterator(s.substr(0, s.size()-1), delim) == expected);
+}
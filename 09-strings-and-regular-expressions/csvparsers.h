@@ -0,0 +1,69 @@
+// All the different ways to split a csv into tokens with the standard library.
+#pragma once
+
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// split_getline uses std::getline to split each line of is on delim.
+inline std::vector<std::string> split_getline(std::istream& is, char delim)
+{
+    std::vector<std::string> tokens;
+    for (std::string line; std::getline(is, line);) {
+        std::istringstream ls{line};
+        for (std::string tok; std::getline(ls, tok, delim);) {
+            tokens.push_back(tok);
+        }
+    }
+    return tokens;
+}
+
+// split_istream_iterator uses std::istream_iterator to split is.
+// NOTE(mmorais): Works only with whitespace delimiter.
+inline std::vector<std::string> split_istream_iterator(std::istream& is)
+{
+    std::vector<std::string> tokens;
+    std::copy(std::istream_iterator<std::string>{is},
+              std::istream_iterator<std::string>{},
+              std::back_inserter(tokens));
+    return tokens;
+}
+
+// split_find_first_of uses std::string::find_first_of to split s on delim or newline.
+// NOTE(mmorais): Works for strings only and state machine of 1 char.
+inline std::vector<std::string> split_find_first_of(const std::string& s, char delim)
+{
+    const char delims[] = {delim, '\n', '\0'};
+    std::vector<std::string> tokens;
+    std::size_t start = 0, end = s.find_first_of(delims);
+    while (end != std::string::npos) {
+        tokens.emplace_back(s.substr(start, end-start));
+        start = end + 1;
+        end = s.find_first_of(delims, start);
+    }
+    // Last token, unless the last line was terminated by a newline.
+    if (s.empty() || s.back() != '\n') {
+        tokens.emplace_back(s.substr(start));
+    }
+    return tokens;
+}
+
+// split_sregex_token_iterator uses std::sregex_token_iterator to split s on
+// matches of delim.
+// NOTE(mmorais): Works for strings only, sregex_iterator requires BidIt.
+// NOTE(mmorais): String cannot have leading or trailing delimiters.
+inline std::vector<std::string> split_sregex_token_iterator(const std::string& s,
+                                                            const std::regex& delim)
+{
+    std::vector<std::string> tokens;
+    std::copy(std::sregex_token_iterator{std::begin(s), std::end(s),
+                                         delim,
+                                         -1}, // -1 return stuff btwn matches.
+              std::sregex_token_iterator{},
+              std::back_inserter(tokens));
+    return tokens;
+}
@@ -0,0 +1,133 @@
+// Benchmark the csv parsers in csvparsers.h against csv_for_each_field.
+#include <cstdint>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csvcolumns.h"
+#include "csvparsers.h"
+#include "csvscan.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_csv returns nrows lines of 8 fields of integers and words, where the
+// words are quoted and contain a delimiter when quoted is true.
+std::string make_csv(std::int64_t nrows, char delim = ',', bool quoted = false)
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> dist{0, 1'000'000};
+    std::string csv;
+    for (std::int64_t r = 0; r != nrows; ++r) {
+        for (int c = 0; c != 8; ++c) {
+            if (c % 2 == 0) {
+                csv += std::to_string(dist(gen));
+            } else if (quoted) {
+                csv += "\"word" + std::to_string(dist(gen) % 100) + delim + " x\"";
+            } else {
+                csv += "word" + std::to_string(dist(gen) % 100);
+            }
+            csv += c == 7 ? '\n' : delim;
+        }
+    }
+    return csv;
+}
+
+// All parsers split the same rows, the whitespace-only istream_iterator splits
+// the rows with spaces in place of commas.
+TIMEIT_BENCHMARK_ARGS("[csv:getline]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg());
+    while (state.keep_running()) {
+        std::istringstream is{csv};
+        timeit::do_not_optimize(split_getline(is, ','));
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[csv:istream_iterator]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg(), ' ');
+    while (state.keep_running()) {
+        std::istringstream is{csv};
+        timeit::do_not_optimize(split_istream_iterator(is));
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[csv:find_first_of]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(split_find_first_of(csv, ','));
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[csv:sregex_token_iterator]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg());
+    csv.pop_back(); // String cannot have trailing delimiters.
+    std::regex delim{R"([\s,]+)"};
+    while (state.keep_running()) {
+        timeit::do_not_optimize(split_sregex_token_iterator(csv, delim));
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[csv:csv_for_each_field]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg());
+    std::vector<std::string_view> tokens;
+    while (state.keep_running()) {
+        tokens.clear();
+        csv_for_each_field(csv, [&tokens](std::string_view field, bool) {
+            tokens.push_back(field);
+        });
+        timeit::do_not_optimize(tokens.data());
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[csv:csv_for_each_field:quoted]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg(), ',', true);
+    std::vector<std::string_view> tokens;
+    while (state.keep_running()) {
+        tokens.clear();
+        csv_for_each_field(csv, [&tokens](std::string_view field, bool) {
+            tokens.push_back(field);
+        });
+        timeit::do_not_optimize(tokens.data());
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+// Columns of make_csv, alternating integers and words.
+const std::vector<ColumnType> make_csv_schema{
+    ColumnType::int64, ColumnType::string, ColumnType::int64, ColumnType::string,
+    ColumnType::int64, ColumnType::string, ColumnType::int64, ColumnType::string};
+
+TIMEIT_BENCHMARK_ARGS("[csv:csv_read_columns]", 10'000, 100'000)
+{
+    auto csv = make_csv(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(csv_read_columns(csv, make_csv_schema));
+    }
+    state.set_bytes_processed(csv.size());
+}
+
+// Scaling of csv_read_columns with the number of threads.
+TIMEIT_BENCHMARK_ARGS("[csv:csv_read_columns:threads]", 1, 2, 4, 8)
+{
+    auto csv = make_csv(1'000'000, ',', true);
+    CsvOptions opts;
+    opts.nthreads = state.arg();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(csv_read_columns(csv, make_csv_schema, opts));
+    }
+    state.set_bytes_processed(csv.size());
+}
@@ -0,0 +1,77 @@
+// Demonstrate splitting csv with quoted fields using SIMD bitmasks.
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "csvscan.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using Records = std::vector<std::vector<std::string_view>>;
+
+TEST_CASE("[_prefix_xor]")
+{
+    // Bits from an opening quote up to, not including, the closing quote.
+    REQUIRE(_prefix_xor(0b0000'0000) == 0b0000'0000);
+    REQUIRE(_prefix_xor(0b0010'0010) == 0b0001'1110);
+    REQUIRE(_prefix_xor(0b1000'0001) == 0b0111'1111);
+    REQUIRE(_prefix_xor(std::uint64_t{1} << 63) == std::uint64_t{1} << 63);
+}
+
+TEST_CASE("[csv_for_each_field]")
+{
+    SUBCASE("unquoted fields")
+    {
+        auto rcv = csv_records("one,two,three\nfour,five\n");
+        REQUIRE(rcv == Records{{"one","two","three"}, {"four","five"}});
+    }
+
+    SUBCASE("last line without newline and empty fields")
+    {
+        auto rcv = csv_records("one,,three\n,five,");
+        REQUIRE(rcv == Records{{"one","","three"}, {"","five",""}});
+    }
+
+    SUBCASE("quoted fields with delimiters, newlines and escapes")
+    {
+        auto rcv = csv_records("\"one,two\",\"three\nfour\",\"say \"\"hi\"\"\"\n");
+        REQUIRE(rcv == Records{{"one,two", "three\nfour", "say \"\"hi\"\""}});
+        REQUIRE(csv_unescape(rcv[0][2]) == "say \"hi\"");
+    }
+
+    SUBCASE("crlf line endings")
+    {
+        auto rcv = csv_records("one,two\r\nthree,four\r\n");
+        REQUIRE(rcv == Records{{"one","two"}, {"three","four"}});
+    }
+
+    SUBCASE("other delimiter")
+    {
+        auto rcv = csv_records("one\ttwo,three\n", '\t');
+        REQUIRE(rcv == Records{{"one","two,three"}});
+    }
+
+    SUBCASE("empty")
+    {
+        REQUIRE(csv_records("").empty());
+    }
+
+    SUBCASE("quotes spanning 64 byte blocks")
+    {
+        // Quoted field opens in the first block and closes in the third.
+        std::string quoted(150, 'x');
+        quoted[70] = ',';
+        quoted[140] = '\n';
+        std::string text = "a,\"" + quoted + "\",b\n";
+        for (int i = 0; i != 10; ++i) {
+            text += std::to_string(i) + ",c\n";
+        }
+
+        auto rcv = csv_records(text);
+        REQUIRE(rcv.size() == 11);
+        REQUIRE(rcv[0] == std::vector<std::string_view>{"a", quoted, "b"});
+        REQUIRE(rcv[10] == std::vector<std::string_view>{"9", "c"});
+    }
+}
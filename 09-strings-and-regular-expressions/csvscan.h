@@ -0,0 +1,143 @@
+// Split csv into fields 64 bytes at a time using SIMD bitmasks.
+//
+// Each 64 byte block is classified into one bit per byte for quotes,
+// delimiters and newlines. The prefix xor of the quote bits marks the bytes
+// inside quoted fields, carried from one block to the next, and the
+// delimiters and newlines outside quotes are the field boundaries. Fields are
+// returned as string_view into the input, without copies.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// _eq_mask returns a mask with bit i set when block[i] == c for i in [0, 64).
+inline std::uint64_t _eq_mask(const char* block, char c)
+{
+#if defined(__AVX2__)
+    const __m256i v = _mm256_set1_epi8(c);
+    auto lo = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), v)));
+    auto hi = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)), v)));
+    return std::uint64_t{lo} | std::uint64_t{hi} << 32;
+#elif defined(__SSE2__)
+    const __m128i v = _mm_set1_epi8(c);
+    std::uint64_t mask = 0;
+    for (int k = 0; k != 4; ++k) {
+        auto m = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * k)), v)));
+        mask |= std::uint64_t{m} << (16 * k);
+    }
+    return mask;
+#else
+    std::uint64_t mask = 0;
+    for (int k = 0; k != 64; ++k) {
+        mask |= std::uint64_t{block[k] == c} << k;
+    }
+    return mask;
+#endif
+}
+
+// _prefix_xor returns a mask where bit i is the xor of bits [0, i] of x, so
+// that the bits from an opening quote up to its closing quote are set.
+inline std::uint64_t _prefix_xor(std::uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// csv_for_each_field calls func(field, end_of_record) for every field of text
+// in order, where end_of_record is true for the last field of each line.
+// Quoted fields may contain delim, newlines and "" escaped quotes; the
+// enclosing quotes are removed but the escapes are not, see csv_unescape.
+// A trailing '\r' is removed from the last field of a record.
+template <typename Func>
+void csv_for_each_field(std::string_view text, Func func, char delim = ',')
+{
+    const char* base = text.data();
+    const std::size_t n = text.size();
+    std::size_t start = 0;      // Start of the current field.
+    std::uint64_t carry = 0;    // All ones when the last block ended inside quotes.
+
+    auto emit = [&](std::size_t end, bool end_of_record) {
+        std::string_view field{base + start, end - start};
+        if (end_of_record && !field.empty() && field.back() == '\r') {
+            field.remove_suffix(1);
+        }
+        if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+            field.remove_prefix(1);
+            field.remove_suffix(1);
+        }
+        func(field, end_of_record);
+        start = end + 1;
+    };
+
+    char tail[64];
+    for (std::size_t i = 0; i < n; i += 64) {
+        // Pad the last partial block with zeros, which are never structural.
+        const char* block = base + i;
+        if (n - i < 64) {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, base + i, n - i);
+            block = tail;
+        }
+
+        std::uint64_t inside = _prefix_xor(_eq_mask(block, '"')) ^ carry;
+        carry = inside >> 63 ? ~std::uint64_t{0} : 0;
+
+        std::uint64_t newlines = _eq_mask(block, '\n');
+        std::uint64_t structural = (_eq_mask(block, delim) | newlines) & ~inside;
+        while (structural != 0) {
+            int bit = __builtin_ctzll(structural);
+            emit(i + bit, (newlines >> bit) & 1);
+            structural &= structural - 1; // Clear lowest set bit.
+        }
+    }
+
+    // Last field of a last line without trailing newline.
+    if (start < n || (n > 0 && base[n - 1] == delim)) {
+        emit(n, true);
+    }
+}
+
+// csv_unescape returns field with each "" escape replaced by a single quote.
+inline std::string csv_unescape(std::string_view field)
+{
+    std::string s;
+    s.reserve(field.size());
+    for (std::size_t i = 0; i < field.size(); ++i) {
+        s += field[i];
+        if (field[i] == '"' && i + 1 < field.size() && field[i + 1] == '"') {
+            ++i;
+        }
+    }
+    return s;
+}
+
+// csv_records returns the fields of text grouped by record.
+inline std::vector<std::vector<std::string_view>>
+csv_records(std::string_view text, char delim = ',')
+{
+    std::vector<std::vector<std::string_view>> records(1);
+    csv_for_each_field(text, [&records](std::string_view field, bool end_of_record) {
+        records.back().push_back(field);
+        if (end_of_record) {
+            records.emplace_back();
+        }
+    }, delim);
+    records.pop_back();
+    return records;
+}
@@ -0,0 +1,167 @@
+// Demonstrate matching a restricted regex with a compiled DFA.
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dfaregex.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using Views = std::vector<std::string_view>;
+
+TEST_CASE("[DfaRegex::match]")
+{
+    struct test_case
+    {
+        std::string pattern;
+        std::string_view input;
+        bool expected;
+    };
+
+    std::vector<test_case> test_cases{
+        {R"(\d{3}-\d{2}-\d{4})", "123-12-1234", true},
+        {R"(\d{3}-\d{2}-\d{4})", "123-12-123", false},
+        {R"(\d{3}-\d{2}-\d{4})", "123-12-12345", false},
+        {"abc", "abc", true},
+        {"abc", "abd", false},
+        {"[a-c]+x", "abcabcx", true},
+        {"[^a-c]", "d", true},
+        {"[^a-c]", "a", false},
+        {"cat|dog", "dog", true},
+        {"cat|dog", "cow", false},
+        {"(ab)*", "", true},
+        {"(ab)*", "abab", true},
+        {"(ab)*", "aba", false},
+        {"a{2,3}", "a", false},
+        {"a{2,3}", "aaa", true},
+        {"a{2,3}", "aaaa", false},
+        {"a{2,}", "aaaaaa", true},
+        {"colou?r", "color", true},
+        {R"(\w+@\w+\.com)", "me@example.com", true},
+        {R"(\w+@\w+\.com)", "me@examplexcom", false},
+        {R"(\S+\s\S+)", "hello world", true},
+        {R"([\d-]+)", "12-34", true},
+        {"a.c", "a\nc", false},
+    };
+
+    for (const auto& c : test_cases) {
+        DfaRegex re{c.pattern};
+        CAPTURE(c.pattern);
+        CAPTURE(c.input);
+        REQUIRE(re.match(c.input) == c.expected);
+        // Agrees with std::regex, which only differs on the match chosen.
+        std::regex pat{c.pattern};
+        REQUIRE(std::regex_match(c.input.begin(), c.input.end(), pat) == c.expected);
+    }
+}
+
+TEST_CASE("[DfaRegex::search]")
+{
+    DfaRegex ssn{R"(\d{3}-\d{2}-\d{4})"};
+    REQUIRE(ssn.search("id 123-12-1234 end") == std::string_view{"123-12-1234"});
+    REQUIRE(ssn.search("1234-12-12345") == std::string_view{"234-12-1234"});
+    REQUIRE_FALSE(ssn.search("123-12-123"));
+
+    // Leftmost-longest, std::regex would match "a" as the first alternative.
+    DfaRegex alt{"a|ab"};
+    REQUIRE(alt.search("xab") == std::string_view{"ab"});
+
+    // The match that ends first is not always the leftmost one.
+    DfaRegex later{"xaby|ab"};
+    REQUIRE(later.search("xxaby") == std::string_view{"xaby"});
+    REQUIRE(later.search("xxabz") == std::string_view{"ab"});
+}
+
+TEST_CASE("[DfaRegex::search:brute force]")
+{
+    // brute_force returns the leftmost-longest match by matching every
+    // substring, the longest first.
+    auto brute_force = [](const DfaRegex& re, std::string_view sv) -> std::optional<std::string_view> {
+        for (std::size_t pos = 0; pos <= sv.size(); ++pos) {
+            for (std::size_t len = sv.size() - pos + 1; len-- != 0; ) {
+                if (re.match(sv.substr(pos, len))) {
+                    return sv.substr(pos, len);
+                }
+            }
+        }
+        return std::nullopt;
+    };
+
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<std::size_t> pick{0, 5};
+    // The last pattern is too large to search but by trying every position.
+    for (const char* pattern : {"a*b", ".*x", "xaby|ab", "(ab|a)(bc|c)?", "b+|c*", "a.{2}y",
+                                "a[ab]{12}"}) {
+        CAPTURE(pattern);
+        DfaRegex re{pattern};
+        for (int n = 0; n != 200; ++n) {
+            // Long runs of a make the tries of a*b and .*x read many bytes.
+            std::string text(n % 10 == 0 ? 80 : 0, 'a');
+            text.resize(text.size() + n % 40);
+            for (auto it = text.end() - n % 40; it != text.end(); ++it) {
+                *it = "abcxy\n"[pick(gen)];
+            }
+            CAPTURE(text);
+            std::string_view sv{text};
+            REQUIRE(re.search(sv) == brute_force(re, sv));
+
+            Views expected;
+            for (std::size_t pos = 0; pos <= sv.size(); ) {
+                auto m = brute_force(re, sv.substr(pos));
+                if (!m) {
+                    break;
+                }
+                expected.push_back(*m);
+                pos = m->data() - sv.data() + std::max<std::size_t>(m->size(), 1);
+            }
+            REQUIRE(re.matches(sv) == expected);
+        }
+    }
+}
+
+TEST_CASE("[DfaRegex::matches]")
+{
+    SUBCASE("non-overlapping matches")
+    {
+        DfaRegex re{"[0-9]+"};
+        REQUIRE(re.matches("a1b22c333") == Views{"1", "22", "333"});
+        REQUIRE(re.matches("none").empty());
+    }
+
+    SUBCASE("matches are views into the text")
+    {
+        std::string text = "x 111-11-1111 y";
+        auto rcv = DfaRegex{R"(\d{3}-\d{2}-\d{4})"}.matches(text);
+        REQUIRE(rcv.size() == 1);
+        REQUIRE(rcv[0].data() == text.data() + 2);
+    }
+
+    SUBCASE("empty matches advance")
+    {
+        DfaRegex re{"a*"};
+        REQUIRE(re.matches("baa") == Views{"", "aa", ""});
+    }
+}
+
+TEST_CASE("[DfaRegex::states]")
+{
+    // Byte classes and subset construction keep a fixed shape small: one
+    // state per position of the pattern, plus the dead state.
+    DfaRegex ssn{R"(\d{3}-\d{2}-\d{4})"};
+    REQUIRE(ssn.states() == 13);
+}
+
+TEST_CASE("[DfaRegex:errors]")
+{
+    for (const char* pattern : {"(ab", "ab)", "[ab", "a{2", "a{3,2}", "*a", R"(\b)", "^a", "a{5000}",
+                                "(a{1000}){1000}"}) {
+        CAPTURE(pattern);
+        REQUIRE_THROWS_AS(DfaRegex{pattern}, std::regex_error);
+    }
+}
@@ -0,0 +1,628 @@
+// Compile a restricted regular expression into a table-driven DFA.
+//
+// The pattern is parsed into a syntax tree, compiled to an NFA and then
+// converted to a DFA by subset construction when the DfaRegex is constructed.
+// Bytes that no pattern character class tells apart share a column of the
+// transition table, so matching costs one table lookup per byte and never
+// allocates. Matches are leftmost-longest, as in POSIX, rather than the
+// leftmost-first of std::regex ECMAScript, which only differs for alternations
+// where one branch is a prefix of another.
+//
+// search runs the DFA from each position of the text where a match may begin
+// for as long as those tries fail after a few bytes, as they do for most
+// patterns. Otherwise, as for a*b or .*x, which would read the rest of the
+// text from each position, a second DFA, of the pattern after any bytes, runs
+// once over the text to the end of the match that ends first, and a third, of
+// the reversed pattern, runs back from there to the leftmost start of a match
+// ending there. Only the positions before that start are then tried, for a
+// match that starts earlier and ends later. Patterns for which the other DFAs
+// are too large are searched by trying every position, which is quadratic in
+// the worst case.
+//
+// Supported syntax:
+//   literals, escaped metacharacters \. \- \\ ...
+//   . \d \D \w \W \s \S [abc] [a-z] [^...]
+//   grouping (...), alternation a|b
+//   repeats * + ? {n} {n,} {n,m}
+// Anchors, backreferences and lookaround throw std::regex_error.
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class DfaRegex
+{
+public:
+    explicit DfaRegex(std::string_view pattern)
+    {
+        Parser parser{pattern};
+        Node root = parser.alternation();
+        if (parser.pos != pattern.size()) {
+            throw std::regex_error{std::regex_constants::error_paren};
+        }
+        forward = compile(root);
+        for (int b = 0; b != 256; ++b) {
+            first[b] = forward.accept[forward.start] ||
+                       forward.next(forward.start, static_cast<char>(b)) != dead;
+        }
+
+        // The pattern after any bytes, and the pattern reversed.
+        Node any{Node::Kind::Repeat, {}, {}, 0, -1};
+        any.kids.push_back(Node{Node::Kind::Set, ByteSet{}.set(), {}, 0, 0});
+        Node after_any{Node::Kind::Concat, {}, {}, 0, 0};
+        after_any.kids.push_back(std::move(any));
+        after_any.kids.push_back(root);
+        try {
+            unanchored = compile(after_any);
+            reverse = compile(reversed(std::move(root)));
+        } catch (const std::regex_error&) {
+            unanchored = reverse = Dfa{}; // Search by trying every position.
+        }
+    }
+
+    // match returns true when the pattern matches all of sv, like std::regex_match.
+    bool match(std::string_view sv) const
+    {
+        std::int32_t s = forward.start;
+        for (char c : sv) {
+            s = forward.next(s, c);
+            if (s == dead) {
+                return false;
+            }
+        }
+        return forward.accept[s];
+    }
+
+    // search returns the leftmost-longest match in sv, like std::regex_search.
+    std::optional<std::string_view> search(std::string_view sv) const
+    {
+        std::size_t len = 0;
+        std::size_t pos = leftmost(sv, 0, len);
+        if (pos == std::string_view::npos) {
+            return std::nullopt;
+        }
+        return sv.substr(pos, len);
+    }
+
+    // for_each_match calls func(match) for every non-overlapping match in sv
+    // from left to right, like std::regex_iterator.
+    template <typename Func>
+    void for_each_match(std::string_view sv, Func func) const
+    {
+        for (std::size_t pos = 0; pos <= sv.size(); ) {
+            std::size_t len = 0;
+            pos = leftmost(sv, pos, len);
+            if (pos == std::string_view::npos) {
+                break;
+            }
+            func(sv.substr(pos, len));
+            pos += std::max<std::size_t>(len, 1); // Step over empty matches.
+        }
+    }
+
+    // matches returns all non-overlapping matches in sv.
+    std::vector<std::string_view> matches(std::string_view sv) const
+    {
+        std::vector<std::string_view> results;
+        for_each_match(sv, [&results](std::string_view m) { results.push_back(m); });
+        return results;
+    }
+
+    // states returns the number of DFA states including the dead state.
+    std::size_t states() const { return forward.accept.size(); }
+
+private:
+    static constexpr std::int32_t dead = 0;
+    // Patterns that need more DFA states than this are rejected.
+    static constexpr std::size_t max_states = 4096;
+    // Counted repeats are expanded, so bound them to keep the NFA small.
+    static constexpr int max_repeat = 1000;
+    // Nested counted repeats multiply, so bound the expanded NFA as well.
+    static constexpr std::size_t max_nfa_states = 1 << 16;
+    // The bytes the tries of search may read, at first and for each byte
+    // they pass, before search turns to the DFAs that find the match.
+    static constexpr std::size_t min_budget = 64;
+    static constexpr std::size_t budget_per_byte = 8;
+    // longest returns unknown when it runs out of budget.
+    static constexpr std::size_t unknown = std::string_view::npos - 1;
+
+    using ByteSet = std::bitset<256>;
+
+    // Dfa is a transition table over byte classes, state 0 is the dead state.
+    struct Dfa
+    {
+        std::int32_t next(std::int32_t s, char c) const
+        {
+            return table[s * nclasses + classes[static_cast<unsigned char>(c)]];
+        }
+
+        std::uint8_t classes[256] = {};
+        std::size_t nclasses = 0;
+        std::vector<std::int32_t> table;
+        std::vector<bool> accept;
+        std::int32_t start = dead;
+    };
+
+    // Node is the syntax tree of a pattern.
+    struct Node
+    {
+        enum class Kind { Set, Concat, Alt, Repeat } kind;
+        ByteSet set;             // Set.
+        std::vector<Node> kids;  // Concat, Alt, Repeat (one kid).
+        int min = 0, max = 0;    // Repeat, max < 0 is unbounded.
+    };
+
+    // Parser is a recursive descent parser of the pattern into a Node.
+    struct Parser
+    {
+        std::string_view re;
+        std::size_t pos = 0;
+
+        bool more() const { return pos < re.size(); }
+        char peek() const { return re[pos]; }
+
+        Node alternation()
+        {
+            Node alt{Node::Kind::Alt, {}, {}, 0, 0};
+            alt.kids.push_back(concatenation());
+            while (more() && peek() == '|') {
+                ++pos;
+                alt.kids.push_back(concatenation());
+            }
+            return alt.kids.size() == 1 ? std::move(alt.kids[0]) : alt;
+        }
+
+        Node concatenation()
+        {
+            Node cat{Node::Kind::Concat, {}, {}, 0, 0};
+            while (more() && peek() != '|' && peek() != ')') {
+                cat.kids.push_back(repetition());
+            }
+            return cat;
+        }
+
+        Node repetition()
+        {
+            Node atom = atomic();
+            while (more()) {
+                int min = 0, max = 0;
+                char c = peek();
+                if (c == '*') {
+                    min = 0, max = -1;
+                } else if (c == '+') {
+                    min = 1, max = -1;
+                } else if (c == '?') {
+                    min = 0, max = 1;
+                } else if (c == '{') {
+                    ++pos;
+                    min = max = number();
+                    if (more() && peek() == ',') {
+                        ++pos;
+                        max = more() && peek() == '}' ? -1 : number();
+                    }
+                    if (!more() || peek() != '}') {
+                        throw std::regex_error{std::regex_constants::error_brace};
+                    }
+                    if (max >= 0 && max < min) {
+                        throw std::regex_error{std::regex_constants::error_badbrace};
+                    }
+                } else {
+                    break;
+                }
+                ++pos;
+                Node rep{Node::Kind::Repeat, {}, {}, min, max};
+                rep.kids.push_back(std::move(atom));
+                atom = std::move(rep);
+            }
+            return atom;
+        }
+
+        int number()
+        {
+            int n = 0;
+            std::size_t begin = pos;
+            while (more() && peek() >= '0' && peek() <= '9') {
+                n = n * 10 + (re[pos++] - '0');
+                if (n > max_repeat) {
+                    throw std::regex_error{std::regex_constants::error_complexity};
+                }
+            }
+            if (pos == begin) {
+                throw std::regex_error{std::regex_constants::error_badbrace};
+            }
+            return n;
+        }
+
+        Node atomic()
+        {
+            char c = re[pos++];
+            switch (c) {
+            case '(': {
+                Node group = alternation();
+                if (!more() || peek() != ')') {
+                    throw std::regex_error{std::regex_constants::error_paren};
+                }
+                ++pos;
+                return group;
+            }
+            case '[':
+                return set(bracket());
+            case '.': {
+                ByteSet any;
+                any.set();
+                any.reset('\n');
+                return set(any);
+            }
+            case '\\':
+                return set(escape());
+            case '*': case '+': case '?': case '{':
+                throw std::regex_error{std::regex_constants::error_badrepeat};
+            case '^': case '$':
+                throw std::regex_error{std::regex_constants::error_complexity};
+            default:
+                return set(ByteSet{}.set(static_cast<unsigned char>(c)));
+            }
+        }
+
+        static Node set(const ByteSet& s)
+        {
+            return Node{Node::Kind::Set, s, {}, 0, 0};
+        }
+
+        ByteSet escape()
+        {
+            if (!more()) {
+                throw std::regex_error{std::regex_constants::error_escape};
+            }
+            char c = re[pos++];
+            ByteSet s;
+            switch (c) {
+            case 'd': case 'D':
+                for (int b = '0'; b <= '9'; ++b) s.set(b);
+                break;
+            case 'w': case 'W':
+                for (int b = 0; b != 256; ++b) {
+                    s[b] = (b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') ||
+                           (b >= '0' && b <= '9') || b == '_';
+                }
+                break;
+            case 's': case 'S':
+                for (char b : {' ', '\t', '\n', '\r', '\v', '\f'}) s.set(b);
+                break;
+            case 'n': return s.set('\n');
+            case 't': return s.set('\t');
+            case 'r': return s.set('\r');
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+                    throw std::regex_error{std::regex_constants::error_escape};
+                }
+                return s.set(static_cast<unsigned char>(c));
+            }
+            return c >= 'A' && c <= 'Z' ? ~s : s; // \D \W \S are complements.
+        }
+
+        ByteSet bracket()
+        {
+            ByteSet s;
+            bool negate = more() && peek() == '^';
+            pos += negate;
+            bool first = true;
+            while (more() && (peek() != ']' || first)) {
+                first = false;
+                if (peek() == '\\') {
+                    ++pos;
+                    s |= escape();
+                    continue;
+                }
+                auto lo = static_cast<unsigned char>(re[pos++]);
+                auto hi = lo;
+                if (pos + 1 < re.size() && peek() == '-' && re[pos + 1] != ']') {
+                    hi = static_cast<unsigned char>(re[pos + 1]);
+                    pos += 2;
+                    if (hi < lo) {
+                        throw std::regex_error{std::regex_constants::error_range};
+                    }
+                }
+                for (int b = lo; b <= hi; ++b) {
+                    s.set(b);
+                }
+            }
+            if (!more()) {
+                throw std::regex_error{std::regex_constants::error_brack};
+            }
+            ++pos;
+            return negate ? ~s : s;
+        }
+    };
+
+    // NfaState consumes a byte in on to reach next, or moves to eps for free.
+    struct NfaState
+    {
+        ByteSet on;
+        int next = -1;
+        std::vector<int> eps;
+    };
+
+    struct Fragment
+    {
+        int start, end;
+    };
+
+    int add_state(std::vector<NfaState>& nfa) const
+    {
+        if (nfa.size() == max_nfa_states) {
+            throw std::regex_error{std::regex_constants::error_complexity};
+        }
+        nfa.emplace_back();
+        return static_cast<int>(nfa.size()) - 1;
+    }
+
+    // thompson appends the states of node to nfa, McNaughton-Yamada-Thompson.
+    Fragment thompson(const Node& node, std::vector<NfaState>& nfa) const
+    {
+        switch (node.kind) {
+        case Node::Kind::Set: {
+            int s = add_state(nfa), e = add_state(nfa);
+            nfa[s].on = node.set;
+            nfa[s].next = e;
+            return {s, e};
+        }
+        case Node::Kind::Concat: {
+            int s = add_state(nfa), cur = s;
+            for (const auto& kid : node.kids) {
+                auto f = thompson(kid, nfa);
+                nfa[cur].eps.push_back(f.start);
+                cur = f.end;
+            }
+            return {s, cur};
+        }
+        case Node::Kind::Alt: {
+            int s = add_state(nfa), e = add_state(nfa);
+            for (const auto& kid : node.kids) {
+                auto f = thompson(kid, nfa);
+                nfa[s].eps.push_back(f.start);
+                nfa[f.end].eps.push_back(e);
+            }
+            return {s, e};
+        }
+        case Node::Kind::Repeat: {
+            int s = add_state(nfa), cur = s;
+            for (int i = 0; i < node.min; ++i) {
+                auto f = thompson(node.kids[0], nfa);
+                nfa[cur].eps.push_back(f.start);
+                cur = f.end;
+            }
+            if (node.max < 0) {
+                // Loop back to a state that may exit or repeat again.
+                auto f = thompson(node.kids[0], nfa);
+                nfa[cur].eps.push_back(f.start);
+                nfa[f.end].eps.push_back(cur);
+                return {s, cur};
+            }
+            int e = add_state(nfa);
+            for (int i = node.min; i < node.max; ++i) {
+                auto f = thompson(node.kids[0], nfa);
+                nfa[cur].eps.push_back(e);
+                nfa[cur].eps.push_back(f.start);
+                cur = f.end;
+            }
+            nfa[cur].eps.push_back(e);
+            return {s, e};
+        }
+        }
+        return {};
+    }
+
+    // closure returns the sorted set of states reachable from set by eps.
+    static std::vector<int> closure(std::vector<int> set, const std::vector<NfaState>& nfa)
+    {
+        std::vector<bool> seen(nfa.size());
+        std::vector<int> stack = set;
+        for (int s : set) {
+            seen[s] = true;
+        }
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            for (int t : nfa[s].eps) {
+                if (!seen[t]) {
+                    seen[t] = true;
+                    set.push_back(t);
+                    stack.push_back(t);
+                }
+            }
+        }
+        std::sort(set.begin(), set.end());
+        return set;
+    }
+
+    // reversed returns node matching the reverse of the strings it matches.
+    static Node reversed(Node node)
+    {
+        if (node.kind == Node::Kind::Concat) {
+            std::reverse(node.kids.begin(), node.kids.end());
+        }
+        for (auto& kid : node.kids) {
+            kid = reversed(std::move(kid));
+        }
+        return node;
+    }
+
+    // compile builds the byte classes and DFA transition table of root.
+    Dfa compile(const Node& root) const
+    {
+        Dfa dfa;
+        std::vector<NfaState> nfa;
+        auto f = thompson(root, nfa);
+
+        // Bytes that belong to the same sets of every state are equivalent.
+        std::map<std::vector<bool>, std::uint8_t> signatures;
+        std::vector<int> rep; // A representative byte of each class.
+        for (int b = 0; b != 256; ++b) {
+            std::vector<bool> sig;
+            for (const auto& s : nfa) {
+                if (s.next >= 0) {
+                    sig.push_back(s.on[b]);
+                }
+            }
+            auto [it, inserted] = signatures.emplace(sig, static_cast<std::uint8_t>(rep.size()));
+            if (inserted) {
+                rep.push_back(b);
+            }
+            dfa.classes[b] = it->second;
+        }
+        dfa.nclasses = rep.size();
+
+        // Subset construction, state 0 is the dead state.
+        std::map<std::vector<int>, std::int32_t> ids{{{}, dead}};
+        std::vector<std::vector<int>> sets{{}};
+        dfa.accept.assign(1, false);
+        dfa.table.assign(dfa.nclasses, dead);
+
+        auto intern = [&](std::vector<int> set) {
+            auto [it, inserted] = ids.emplace(set, static_cast<std::int32_t>(sets.size()));
+            if (inserted) {
+                if (sets.size() == max_states) {
+                    throw std::regex_error{std::regex_constants::error_complexity};
+                }
+                dfa.accept.push_back(std::binary_search(set.begin(), set.end(), f.end));
+                dfa.table.resize(dfa.table.size() + dfa.nclasses, dead);
+                sets.push_back(std::move(set));
+            }
+            return it->second;
+        };
+
+        dfa.start = intern(closure({f.start}, nfa));
+        for (std::size_t d = 1; d < sets.size(); ++d) {
+            for (std::size_t k = 0; k != dfa.nclasses; ++k) {
+                std::vector<int> moved;
+                for (int s : sets[d]) {
+                    if (nfa[s].next >= 0 && nfa[s].on[rep[k]]) {
+                        moved.push_back(nfa[s].next);
+                    }
+                }
+                std::int32_t t = moved.empty() ? dead : intern(closure(std::move(moved), nfa));
+                dfa.table[d * dfa.nclasses + k] = t;
+            }
+        }
+        return dfa;
+    }
+
+    // skip returns the first position from pos where a match may begin.
+    std::size_t skip(std::string_view sv, std::size_t pos) const
+    {
+        while (pos < sv.size() && !first[static_cast<unsigned char>(sv[pos])]) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    // longest returns the length of the longest match at pos or npos, or
+    // unknown once it has read budget bytes, which it takes from budget.
+    std::size_t longest(std::string_view sv, std::size_t pos, std::size_t& budget) const
+    {
+        std::size_t len = forward.accept[forward.start] ? 0 : std::string_view::npos;
+        std::int32_t s = forward.start;
+        for (std::size_t i = pos; i < sv.size(); ++i) {
+            if (budget == 0) {
+                return unknown;
+            }
+            --budget;
+            s = forward.next(s, sv[i]);
+            if (s == dead) {
+                break;
+            }
+            if (forward.accept[s]) {
+                len = i + 1 - pos;
+            }
+        }
+        return len;
+    }
+
+    std::size_t longest(std::string_view sv, std::size_t pos) const
+    {
+        std::size_t budget = std::string_view::npos;
+        return longest(sv, pos, budget);
+    }
+
+    // leftmost returns the start of the leftmost-longest match in sv from pos
+    // and sets len to its length, or returns npos. It tries each position
+    // while the tries read a few bytes for each byte they pass, as for most
+    // patterns and texts, and otherwise finds the match with the other DFAs.
+    std::size_t leftmost(std::string_view sv, std::size_t pos, std::size_t& len) const
+    {
+        constexpr auto npos = std::string_view::npos;
+        bool bounded = !unanchored.accept.empty();
+        std::size_t budget = min_budget;
+        for (std::size_t from = pos; pos <= sv.size(); from = pos, pos = skip(sv, pos + 1)) {
+            pos = skip(sv, pos);
+            budget += budget_per_byte * (pos - from);
+            len = bounded ? longest(sv, pos, budget) : longest(sv, pos);
+            if (len == unknown) {
+                return leftmost_dfa(sv, pos, len);
+            }
+            if (len != npos) {
+                return pos;
+            }
+        }
+        return npos;
+    }
+
+    // leftmost_dfa is leftmost in linear time, for the most part.
+    std::size_t leftmost_dfa(std::string_view sv, std::size_t pos, std::size_t& len) const
+    {
+        constexpr auto npos = std::string_view::npos;
+
+        // The end of the match that ends first. Bytes that cannot begin a
+        // match lead back to the start state, so they are skipped as well.
+        std::int32_t s = unanchored.start;
+        std::size_t end = unanchored.accept[s] ? pos : npos;
+        for (std::size_t i = skip(sv, pos); end == npos && i < sv.size(); ) {
+            s = unanchored.next(s, sv[i++]);
+            if (unanchored.accept[s]) {
+                end = i;
+            } else if (s == unanchored.start) {
+                i = skip(sv, i);
+            }
+        }
+        if (end == npos) {
+            return npos;
+        }
+
+        // The leftmost start of a match ending there.
+        s = reverse.start;
+        std::size_t begin = end;
+        for (std::size_t i = end; i > pos; --i) {
+            s = reverse.next(s, sv[i - 1]);
+            if (s == dead) {
+                break;
+            }
+            if (reverse.accept[s]) {
+                begin = i - 1;
+            }
+        }
+
+        // A match may start before it and end after it.
+        for (pos = skip(sv, pos); pos < begin; pos = skip(sv, pos + 1)) {
+            len = longest(sv, pos);
+            if (len != npos) {
+                return pos;
+            }
+        }
+        len = longest(sv, begin);
+        return begin;
+    }
+
+    Dfa forward;    // The pattern, anchored at a start position.
+    Dfa unanchored; // The pattern after any bytes, empty if too large.
+    Dfa reverse;    // The reversed pattern, empty if unanchored is.
+    bool first[256] = {};
+};
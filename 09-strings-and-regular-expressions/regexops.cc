@@ -7,34 +7,11 @@
 #include <string_view>
 #include <vector>
 
+#include "regexops.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// is_ssn demonstrates use of std::regex_match to match SSN.
-bool is_ssn(std::string_view sv)
-{
-    static std::regex pat{R"(\d{3}-\d{2}-\d{4})"}; // Raw string syntax.
-    return std::regex_match(std::begin(sv), std::end(sv), pat);
-}
-
-// read_ssn demonstrates use of std::regex_iterator to return SSN from stream.
-std::vector<std::string> read_ssn(std::istream& is)
-{
-    static std::regex pat{R"(\d{3}-\d{2}-\d{4})"}; // Raw string syntax.
-
-    std::vector<std::string> results;
-    for (std::string line; std::getline(is, line); ) {
-        // Find and append all ssn appearing on the line to results.
-        auto mbegin = std::sregex_iterator(std::begin(line), std::end(line), pat);
-        auto mend = std::sregex_iterator{};
-        for (auto m = mbegin; m != mend; ++m) {
-            results.push_back((*m).str());
-        }
-    }
-
-    return results;
-}
-
 TEST_CASE("[std::regex_match]")
 {
     using namespace std::string_view_literals; // Required.
@@ -72,6 +49,7 @@ TEST_CASE("[std::regex_match]")
         auto rcv = is_ssn(c.input);
         CAPTURE(c.input);
         REQUIRE(rcv == c.expected);
+        REQUIRE(is_ssn_dfa(c.input) == c.expected);
     }
 }
 
@@ -79,7 +57,7 @@ TEST_CASE("[std::regex_iterator]")
 {
     using namespace std::string_literals; // Required.
 
-    std::istringstream is(
+    const std::string text(
         "header line\n"
         "111-11-1111\n"             // Same as std::regex_match.
         " 222-22-2222 \n"           // Leading and trailing whitespace.
@@ -87,6 +65,7 @@ TEST_CASE("[std::regex_iterator]")
         "444-44-4444 555-55-5555\n" // Multiple matches on same line.
         "last line\n"
     );
+    std::istringstream is{text};
 
     std::vector<std::string> expected{
         "111-11-1111"s,
@@ -99,6 +78,10 @@ TEST_CASE("[std::regex_iterator]")
     auto rcv = read_ssn(is);
     REQUIRE(rcv.size() == expected.size());
     REQUIRE(rcv == expected);
+
+    // The DFA scans the whole buffer instead of line by line.
+    auto views = read_ssn_dfa(text);
+    REQUIRE(std::vector<std::string>(views.begin(), views.end()) == expected);
 }
 
 TEST_CASE("[std::regex_replace]")
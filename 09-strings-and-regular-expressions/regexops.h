@@ -0,0 +1,51 @@
+// Match SSN with std::regex and with a compiled DFA.
+#pragma once
+
+#include <istream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dfaregex.h"
+
+// is_ssn demonstrates use of std::regex_match to match SSN.
+inline bool is_ssn(std::string_view sv)
+{
+    static std::regex pat{R"(\d{3}-\d{2}-\d{4})"}; // Raw string syntax.
+    return std::regex_match(std::begin(sv), std::end(sv), pat);
+}
+
+// read_ssn demonstrates use of std::regex_iterator to return SSN from stream.
+inline std::vector<std::string> read_ssn(std::istream& is)
+{
+    static std::regex pat{R"(\d{3}-\d{2}-\d{4})"}; // Raw string syntax.
+
+    std::vector<std::string> results;
+    for (std::string line; std::getline(is, line); ) {
+        // Find and append all ssn appearing on the line to results.
+        auto mbegin = std::sregex_iterator(std::begin(line), std::end(line), pat);
+        auto mend = std::sregex_iterator{};
+        for (auto m = mbegin; m != mend; ++m) {
+            results.push_back((*m).str());
+        }
+    }
+
+    return results;
+}
+
+// is_ssn_dfa matches SSN like is_ssn using a DFA compiled from the same pattern.
+inline bool is_ssn_dfa(std::string_view sv)
+{
+    static const DfaRegex pat{R"(\d{3}-\d{2}-\d{4})"};
+    return pat.match(sv);
+}
+
+// read_ssn_dfa returns the SSN of text like read_ssn, but scans the whole
+// buffer at once and returns views into text rather than copies of each line.
+inline std::vector<std::string_view> read_ssn_dfa(std::string_view text)
+{
+    static const DfaRegex pat{R"(\d{3}-\d{2}-\d{4})"};
+    return pat.matches(text);
+}
@@ -0,0 +1,99 @@
+// Benchmark std::regex against DfaRegex to find SSN in text.
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "regexops.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_corpus returns nbytes of lines of words and numbers where about one
+// line in 10 holds an SSN, like a log to be scrubbed of PII.
+std::string make_corpus(std::int64_t nbytes)
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> digit{0, 9};
+    std::uniform_int_distribution<int> word{0, 15};
+    const char* words[] = {"user", "id", "order", "paid", "phone", "555-1234",
+                           "at", "2020-01-02", "the", "account", "number", "42",
+                           "of", "ok", "status", "ref"};
+    std::string text;
+    auto digits = [&](int n) {
+        for (int i = 0; i != n; ++i) {
+            text += static_cast<char>('0' + digit(gen));
+        }
+    };
+    while (static_cast<std::int64_t>(text.size()) < nbytes) {
+        for (int w = 0; w != 8; ++w) {
+            text += words[word(gen)];
+            text += ' ';
+        }
+        if (digit(gen) == 0) {
+            digits(3), text += '-', digits(2), text += '-', digits(4);
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+constexpr std::int64_t MB = 1 << 20;
+
+TIMEIT_BENCHMARK_ARGS("[ssn:read_ssn]", 1 * MB, 8 * MB)
+{
+    auto text = make_corpus(state.arg());
+    while (state.keep_running()) {
+        std::istringstream is{text};
+        timeit::do_not_optimize(read_ssn(is));
+    }
+    state.set_bytes_processed(text.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[ssn:read_ssn_dfa]", 1 * MB, 8 * MB, 64 * MB)
+{
+    auto text = make_corpus(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(read_ssn_dfa(text));
+    }
+    state.set_bytes_processed(text.size());
+}
+
+// The lines of the corpus checked one by one for an exact match.
+TIMEIT_BENCHMARK_ARGS("[ssn:is_ssn]", 10'000)
+{
+    auto text = make_corpus(state.arg() * 64);
+    std::vector<std::string> lines;
+    std::istringstream is{text};
+    for (std::string line; std::getline(is, line);) {
+        lines.push_back(line);
+    }
+    while (state.keep_running()) {
+        int n = 0;
+        for (const auto& line : lines) {
+            n += is_ssn(line);
+        }
+        timeit::do_not_optimize(n);
+    }
+    state.set_items_processed(lines.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[ssn:is_ssn_dfa]", 10'000)
+{
+    auto text = make_corpus(state.arg() * 64);
+    std::vector<std::string> lines;
+    std::istringstream is{text};
+    for (std::string line; std::getline(is, line);) {
+        lines.push_back(line);
+    }
+    while (state.keep_running()) {
+        int n = 0;
+        for (const auto& line : lines) {
+            n += is_ssn_dfa(line);
+        }
+        timeit::do_not_optimize(n);
+    }
+    state.set_items_processed(lines.size());
+}
@@ -0,0 +1,58 @@
+// Demonstrate read-only memory mapping of a file with a resource handle.
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "mapped_file.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+TEST_CASE("[MappedFile]")
+{
+    // Create a file used to exercise MappedFile.
+    std::string filename{"mapped_file_test.txt"};
+    std::string contents{"line number 1\nline number 2\n"};
+
+    // Setup.
+    {
+        std::ofstream os{filename};
+        os << contents;
+    }
+
+    SUBCASE("view of file contents")
+    {
+        MappedFile f{filename};
+        REQUIRE(f.size() == contents.size());
+        REQUIRE(f.view() == contents);
+    }
+
+    SUBCASE("move transfers the mapping")
+    {
+        MappedFile f1{filename};
+        MappedFile f2{std::move(f1)};
+        REQUIRE(f1.size() == 0);
+        REQUIRE(f1.data() == nullptr);
+        REQUIRE(f2.view() == contents);
+    }
+
+    SUBCASE("empty file")
+    {
+        std::string empty{"mapped_file_empty.txt"};
+        { std::ofstream os{empty}; }
+        MappedFile f{empty};
+        REQUIRE(f.size() == 0);
+        REQUIRE(f.view().empty());
+        std::remove(empty.c_str());
+    }
+
+    SUBCASE("MappedFile throws")
+    {
+        REQUIRE_THROWS_AS(MappedFile{"file_does_not_exist.txt"},
+                          std::runtime_error);
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,87 @@
+// Map a file read-only into memory raising std::runtime_error if error.
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// MappedFile is a resource handle for a read-only, private mapping of a file.
+// The contents are exposed as a string_view valid for the lifetime of the
+// handle, so parsers can return views into the file instead of copies.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1) {
+            throw std::runtime_error{strerror(errno)};
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error{strerror(err)};
+        }
+        sz = static_cast<std::size_t>(st.st_size);
+
+        // mmap rejects zero length, an empty file is an empty view.
+        if (sz > 0) {
+            void* p = ::mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                int err = errno;
+                ::close(fd);
+                throw std::runtime_error{strerror(err)};
+            }
+            addr = static_cast<const char*>(p);
+            // Hint that the file is read front to back to enable readahead.
+            ::madvise(p, sz, MADV_SEQUENTIAL);
+        }
+
+        // The mapping remains valid after the descriptor is closed.
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Move constructor.
+    MappedFile(MappedFile&& rhs) noexcept
+    {
+        std::swap(addr, rhs.addr);
+        std::swap(sz, rhs.sz);
+    }
+
+    // Move-assignment, the previous mapping is released by rhs.
+    MappedFile& operator=(MappedFile&& rhs) noexcept
+    {
+        std::swap(addr, rhs.addr);
+        std::swap(sz, rhs.sz);
+        return *this;
+    }
+
+    ~MappedFile()
+    {
+        if (addr != nullptr) {
+            ::munmap(const_cast<char*>(addr), sz);
+        }
+    }
+
+    const char* data() const { return addr; }
+    std::size_t size() const { return sz; }
+    std::string_view view() const { return {addr, sz}; }
+
+private:
+    const char* addr = nullptr;
+    std::size_t sz = 0;
+};
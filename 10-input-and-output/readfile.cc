@@ -1,38 +1,18 @@
 // Read a file line-by-line raising std::runtime_error if error.
 #include <algorithm>
-#include <cerrno>
 #include <cstdio>
-#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "readfile.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// read_lines returns vector of lines from file or throws.
-std::vector<std::string>
-read_lines(const std::string& filename)
-{
-    std::ifstream is{filename};
-    if (!is.is_open()) {
-        throw std::runtime_error{strerror(errno)};
-    }
-
-    std::vector<std::string> lines;
-    for (std::string line; getline(is, line); ) {
-        lines.emplace_back(line);
-    }
-
-    if (is.bad()) {
-        throw std::runtime_error{strerror(errno)};
-    }
-
-    return lines;
-}
-
 TEST_CASE("[read_lines]")
 {
     // Create a file used to exercise read_lines.
@@ -68,3 +48,78 @@ TEST_CASE("[read_lines]")
 
     std::remove(filename.c_str());
 }
+
+TEST_CASE("[for_each_newline]")
+{
+    // Newlines in the SIMD blocks and in the remaining bytes.
+    std::string text(100, 'x');
+    std::vector<std::size_t> expected{0, 15, 16, 31, 32, 63, 64, 99};
+    for (auto pos : expected) {
+        text[pos] = '\n';
+    }
+
+    std::vector<std::size_t> rcv;
+    for_each_newline(text, [&rcv](std::size_t pos) { rcv.push_back(pos); });
+    REQUIRE(rcv == expected);
+}
+
+TEST_CASE("[MappedLines]")
+{
+    // Create a file used to exercise MappedLines.
+    std::string filename{"mappedlines_test.txt"};
+
+    // write_and_read returns the lines of contents from MappedLines and read_lines.
+    auto write_and_read = [&filename](const std::string& contents) {
+        {
+            std::ofstream os{filename};
+            os << contents;
+        }
+        MappedLines rcv{filename};
+        return std::make_pair(std::vector<std::string>(rcv.begin(), rcv.end()),
+                              read_lines(filename));
+    };
+
+    SUBCASE("same lines as read_lines")
+    {
+        std::vector<std::string> lines{
+            "line number 1",
+            "line number 2 is longer than one 32 byte block",
+            "",
+            "line number 4",
+        };
+        std::string contents;
+        for (const auto& line : lines) {
+            contents += line + '\n';
+        }
+
+        auto [rcv, expected] = write_and_read(contents);
+        REQUIRE(rcv == lines);
+        REQUIRE(rcv == expected);
+
+        MappedLines ml{filename};
+        REQUIRE(ml.size() == lines.size());
+        REQUIRE(ml[1] == lines[1]);
+    }
+
+    SUBCASE("last line without newline")
+    {
+        auto [rcv, expected] = write_and_read("one\ntwo");
+        REQUIRE(rcv == std::vector<std::string>{"one", "two"});
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("empty file")
+    {
+        auto [rcv, expected] = write_and_read("");
+        REQUIRE(rcv.empty());
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("MappedLines throws")
+    {
+        REQUIRE_THROWS_AS(MappedLines{"file_does_not_exist.txt"},
+                          std::runtime_error);
+    }
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,131 @@
+// Read a file line-by-line raising std::runtime_error if error.
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "mapped_file.h"
+
+// read_lines returns vector of lines from file or throws.
+inline std::vector<std::string>
+read_lines(const std::string& filename)
+{
+    std::ifstream is{filename};
+    if (!is.is_open()) {
+        throw std::runtime_error{strerror(errno)};
+    }
+
+    std::vector<std::string> lines;
+    for (std::string line; getline(is, line); ) {
+        lines.emplace_back(line);
+    }
+
+    if (is.bad()) {
+        throw std::runtime_error{strerror(errno)};
+    }
+
+    return lines;
+}
+
+// for_each_newline calls func(pos) for the position of every '\n' in text in
+// increasing order, comparing 32 or 16 bytes per instruction when AVX2 or
+// SSE2 is available.
+template <typename Func>
+void for_each_newline(std::string_view text, Func func)
+{
+    const char* base = text.data();
+    std::size_t n = text.size();
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; i + 32 <= n; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + i));
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, nl)));
+        while (mask != 0) {
+            func(i + __builtin_ctz(mask));
+            mask &= mask - 1; // Clear lowest set bit.
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + i));
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, nl)));
+        while (mask != 0) {
+            func(i + __builtin_ctz(mask));
+            mask &= mask - 1; // Clear lowest set bit.
+        }
+    }
+#endif
+    // Remaining bytes, or all bytes without SIMD.
+    for (; i < n; ++i) {
+        if (base[i] == '\n') {
+            func(i);
+        }
+    }
+}
+
+// MappedLines is a memory-mapped file exposed as a random-access range of
+// lines. Lines are string_view into the mapping without the trailing '\n',
+// split the same way as std::getline, and valid for the lifetime of the
+// MappedLines. Throws std::runtime_error if the file cannot be mapped.
+class MappedLines
+{
+public:
+    using const_iterator = std::vector<std::string_view>::const_iterator;
+
+    explicit MappedLines(const std::string& filename)
+        : file{filename}
+    {
+        auto text = file.view();
+        std::size_t start = 0;
+        for_each_newline(text, [&](std::size_t pos) {
+            lines.push_back(text.substr(start, pos - start));
+            start = pos + 1;
+        });
+        // Last line without trailing newline.
+        if (start < text.size()) {
+            lines.push_back(text.substr(start));
+        }
+    }
+
+    std::string_view operator[](std::size_t i) const
+    {
+        return lines[i];
+    }
+
+    std::size_t size() const
+    {
+        return lines.size();
+    }
+
+    bool empty() const
+    {
+        return lines.empty();
+    }
+
+    const_iterator begin() const
+    {
+        return lines.begin();
+    }
+
+    const_iterator end() const
+    {
+        return lines.end();
+    }
+
+private:
+    MappedFile file;
+    std::vector<std::string_view> lines;
+};
@@ -0,0 +1,62 @@
+// Benchmark read_lines and MappedLines on files of short lines.
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "readfile.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// LinesFile is a temporary file of nlines short lines, written once and
+// removed when the benchmark returns.
+struct LinesFile
+{
+    explicit LinesFile(std::int64_t nlines)
+        : filename{(std::filesystem::temp_directory_path() /
+                    ("readfile_bench." + std::to_string(::getpid()) + ".txt")).string()}
+    {
+        std::ofstream os{filename};
+        for (std::int64_t i = 0; i != nlines; ++i) {
+            std::string line = "line number " + std::to_string(i) + '\n';
+            nbytes += line.size();
+            os << line;
+        }
+    }
+
+    ~LinesFile()
+    {
+        std::filesystem::remove(filename);
+    }
+
+    LinesFile(const LinesFile&) = delete;
+    LinesFile& operator=(const LinesFile&) = delete;
+
+    std::string filename;
+    std::size_t nbytes = 0;
+};
+
+TIMEIT_BENCHMARK_ARGS("[read_lines]", 1'000, 100'000, 1'000'000)
+{
+    LinesFile file{state.arg()};
+    while (state.keep_running()) {
+        timeit::do_not_optimize(read_lines(file.filename));
+    }
+    state.set_items_processed(state.arg());
+    state.set_bytes_processed(file.nbytes);
+}
+
+TIMEIT_BENCHMARK_ARGS("[MappedLines]", 1'000, 100'000, 1'000'000)
+{
+    LinesFile file{state.arg()};
+    while (state.keep_running()) {
+        MappedLines lines{file.filename};
+        timeit::do_not_optimize(lines);
+    }
+    state.set_items_processed(state.arg());
+    state.set_bytes_processed(file.nbytes);
+}
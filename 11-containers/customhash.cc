@@ -9,6 +9,8 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "flat_hash_map.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
@@ -82,6 +84,24 @@ TEST_CASE("[customhash]")
         REQUIRE(f2 == std::end(m1));
     }
 
+    SUBCASE("FlatHashMap")
+    {
+        // Drop-in for std::unordered_map, using the same std::hash<std::tuple>.
+        using XYZ = std::tuple<double, double, double>;
+        FlatHashMap<XYZ, std::string> m1{
+            {{0.,0.,0.}, "origin"s},
+            {{1.,1.,1.}, "ones"s},
+            {{-1.,-1.,-1.}, "negones"s}
+        };
+
+        auto f1 = m1.find({0.,0.,0.});
+        REQUIRE(f1 != std::end(m1));
+        REQUIRE((*f1).second == "origin"s);
+
+        auto f2 = m1.find({2.,4.,6.});
+        REQUIRE(f2 == std::end(m1));
+    }
+
     SUBCASE("std::unordered_set:lambda")
     {
         // Use lambda functions for Hash and KeyEqual.
@@ -117,4 +137,25 @@ TEST_CASE("[customhash]")
         // Expected to not find.
         REQUIRE(s1.count({3, 0}) == 0);
     }
+
+    SUBCASE("FlatHashMap:lambda")
+    {
+        auto DivHash = [](const std::div_t& dv) -> std::size_t {
+            return hash_value(dv.quot) ^ hash_value(dv.rem) << 1;
+        };
+        auto DivEquals = [](const std::div_t& d1, const std::div_t& d2) {
+            return d1.quot == d2.quot && d1.rem == d2.rem;
+        };
+
+        FlatHashMap<std::div_t, int,
+                    decltype(DivHash),
+                    decltype(DivEquals)> m1(10, DivHash, DivEquals);
+        for (int i = 1; i != 7; ++i) {
+            m1[std::div(i, 3)] = i;
+        }
+
+        REQUIRE(m1.size() == 6);
+        REQUIRE(m1.at({0, 1}) == 1);
+        REQUIRE(m1.count({3, 0}) == 0);
+    }
 }
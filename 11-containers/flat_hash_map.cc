@@ -0,0 +1,138 @@
+// Demonstrate an open addressing hash map with SIMD probing.
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "flat_hash_map.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using namespace std::string_literals; // Required.
+
+TEST_CASE("[FlatHashMap]")
+{
+    SUBCASE("insert, find and erase")
+    {
+        FlatHashMap<std::string, int> m{{"one"s, 1}, {"two"s, 2}};
+        REQUIRE(m.size() == 2);
+        REQUIRE(m.at("one"s) == 1);
+        REQUIRE(m.find("three"s) == m.end());
+        REQUIRE_THROWS_AS(m.at("three"s), std::out_of_range);
+
+        // insert does not replace, operator[] inserts a default value.
+        REQUIRE_FALSE(m.insert({"one"s, 10}).second);
+        REQUIRE(m["one"s] == 1);
+        m["three"s] = 3;
+        REQUIRE(m.size() == 3);
+        REQUIRE(m.count("three"s) == 1);
+
+        REQUIRE(m.erase("two"s) == 1);
+        REQUIRE(m.erase("two"s) == 0);
+        REQUIRE(m.size() == 2);
+        REQUIRE(m.count("two"s) == 0);
+    }
+
+    SUBCASE("iteration visits every element once")
+    {
+        FlatHashMap<int, int> m;
+        for (int i = 0; i != 1000; ++i) {
+            m[i] = i * i;
+        }
+        int n = 0;
+        long sum = 0;
+        for (const auto& [k, v] : m) {
+            REQUIRE(v == k * k);
+            sum += k;
+            ++n;
+        }
+        REQUIRE(n == 1000);
+        REQUIRE(sum == 999 * 1000 / 2);
+
+        // Erase while iterating.
+        for (auto it = m.begin(); it != m.end(); ) {
+            it = it->first % 2 == 0 ? m.erase(it) : std::next(it);
+        }
+        REQUIRE(m.size() == 500);
+    }
+
+    SUBCASE("matches std::map under random operations")
+    {
+        // Many erases leave tombstones, which inserts reuse or rehash drops.
+        std::default_random_engine gen{};
+        std::uniform_int_distribution<int> key{0, 2000};
+        FlatHashMap<int, int> m;
+        std::map<int, int> expected;
+        for (int n = 0; n != 200'000; ++n) {
+            int k = key(gen);
+            if (n % 3 == 0) {
+                REQUIRE(m.erase(k) == expected.erase(k));
+            } else {
+                m[k] = n;
+                expected[k] = n;
+            }
+        }
+        REQUIRE(m.size() == expected.size());
+        for (const auto& [k, v] : expected) {
+            REQUIRE(m.at(k) == v);
+        }
+        // Tombstones do not grow the table beyond the elements it holds.
+        REQUIRE(m.capacity() <= 4096);
+    }
+
+    SUBCASE("copy and move")
+    {
+        FlatHashMap<int, std::string> m1{{1, "one"s}, {2, "two"s}};
+        auto m2 = m1;
+        m2[3] = "three"s;
+        REQUIRE(m1.size() == 2);
+        REQUIRE(m2.size() == 3);
+        auto m3 = std::move(m2);
+        REQUIRE(m3.at(3) == "three"s);
+        m1 = m3;
+        REQUIRE(m1.size() == 3);
+    }
+
+    SUBCASE("a throwing constructor leaves the map unchanged")
+    {
+        struct Value
+        {
+            explicit Value(bool fail)
+            {
+                if (fail) {
+                    throw std::runtime_error{"fail"};
+                }
+            }
+        };
+        FlatHashMap<int, Value> m;
+        m.reserve(64);
+        auto cap = m.capacity();
+        // Keep the table near its load limit, so that erasing leaves
+        // tombstones, and fail to insert into each one before reusing it.
+        int n = static_cast<int>(cap) * 7 / 8 - 1;
+        for (int i = 0; i != n; ++i) {
+            m.try_emplace(i, false);
+        }
+        for (int i = n; i != 100 * n; ++i) {
+            m.erase(i - n);
+            REQUIRE_THROWS_AS(m.try_emplace(i, true), std::runtime_error);
+            REQUIRE(m.find(i) == m.end());
+            m.try_emplace(i, false);
+        }
+        REQUIRE(m.size() == static_cast<std::size_t>(n));
+        REQUIRE(m.find(-1) == m.end());
+    }
+
+    SUBCASE("reserve")
+    {
+        FlatHashMap<int, int> m;
+        m.reserve(1000);
+        auto cap = m.capacity();
+        for (int i = 0; i != 1000; ++i) {
+            m[i] = i;
+        }
+        REQUIRE(m.capacity() == cap);
+    }
+}
@@ -0,0 +1,484 @@
+// Open addressing hash map with SIMD probing of control byte groups.
+//
+// FlatHashMap follows the design of the Swiss tables of Abseil. Elements are
+// stored in one array of slots, without a node per element, and each slot has
+// a control byte that is either empty, deleted (a tombstone) or full with 7
+// bits of the hash of its key. A lookup loads the control bytes of a group of
+// 16 slots and compares them all at once with the 7 bits of the hash of the
+// key, so the keys themselves are only compared on a likely match. Groups are
+// probed in triangular order, which visits every group of a power of two
+// capacity, until a group with an empty slot ends the search.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Control bytes, full slots hold 7 bits of hash in [0, 128).
+constexpr std::int8_t _ctrl_empty = -128;
+constexpr std::int8_t _ctrl_deleted = -2;
+constexpr std::size_t _group_size = 16;
+
+// _Group is the control bytes of 16 consecutive slots. The match functions
+// return a mask with bit i set when slot i matches.
+struct _Group
+{
+#if defined(__SSE2__)
+    explicit _Group(const std::int8_t* ctrl)
+        : ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))}
+    {}
+
+    std::uint32_t match(std::int8_t h2) const
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+    }
+
+    std::uint32_t match_empty() const
+    {
+        return match(_ctrl_empty);
+    }
+
+    // Empty and deleted are the only negative control bytes.
+    std::uint32_t match_empty_or_deleted() const
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+
+    __m128i ctrl;
+#else
+    explicit _Group(const std::int8_t* ctrl)
+    {
+        std::memcpy(bytes, ctrl, _group_size);
+    }
+
+    std::uint32_t match(std::int8_t h2) const
+    {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i != _group_size; ++i) {
+            mask |= std::uint32_t{bytes[i] == h2} << i;
+        }
+        return mask;
+    }
+
+    std::uint32_t match_empty() const
+    {
+        return match(_ctrl_empty);
+    }
+
+    std::uint32_t match_empty_or_deleted() const
+    {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i != _group_size; ++i) {
+            mask |= std::uint32_t{bytes[i] < 0} << i;
+        }
+        return mask;
+    }
+
+    std::int8_t bytes[_group_size];
+#endif
+};
+
+// _mix_hash spreads the entropy of weak hashes, like std::hash<int> which is
+// the identity, over all the bits, since the map uses both the high and the
+// low bits of the hash.
+inline std::size_t _mix_hash(std::size_t h)
+{
+    h ^= h >> 32;
+    h *= 0x9e3779b97f4a7c15ULL;
+    h ^= h >> 29;
+    return h;
+}
+
+template <typename Key,
+          typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        Iterator() = default;
+
+        // Conversion from iterator to const_iterator.
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& it) : map{it.map}, i{it.i} {}
+
+        reference operator*() const { return map->slots[i]; }
+        pointer operator->() const { return &map->slots[i]; }
+
+        Iterator& operator++()
+        {
+            i = map->next_full(i + 1);
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const Iterator& rhs) const { return i == rhs.i; }
+        bool operator!=(const Iterator& rhs) const { return i != rhs.i; }
+
+    private:
+        friend class FlatHashMap;
+        friend class Iterator<!Const>;
+
+        using Map = std::conditional_t<Const, const FlatHashMap, FlatHashMap>;
+        Iterator(Map* map, std::size_t i) : map{map}, i{i} {}
+
+        Map* map = nullptr;
+        std::size_t i = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    explicit FlatHashMap(std::size_t bucket_count = 0,
+                         const Hash& hash = Hash(),
+                         const KeyEqual& equal = KeyEqual())
+        : hash{hash}, equal{equal}
+    {
+        reserve(bucket_count);
+    }
+
+    FlatHashMap(std::initializer_list<value_type> init,
+                std::size_t bucket_count = 0,
+                const Hash& hash = Hash(),
+                const KeyEqual& equal = KeyEqual())
+        : FlatHashMap(std::max(bucket_count, init.size()), hash, equal)
+    {
+        for (const auto& v : init) {
+            insert(v);
+        }
+    }
+
+    FlatHashMap(const FlatHashMap& rhs)
+        : FlatHashMap(rhs.size(), rhs.hash, rhs.equal)
+    {
+        for (const auto& v : rhs) {
+            insert(v);
+        }
+    }
+
+    FlatHashMap(FlatHashMap&& rhs) noexcept
+        : hash{rhs.hash}, equal{rhs.equal}
+    {
+        swap_table(rhs);
+    }
+
+    // Copy-and-swap assignment for both copy and move.
+    FlatHashMap& operator=(FlatHashMap rhs) noexcept
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    ~FlatHashMap()
+    {
+        destroy();
+    }
+
+    void swap(FlatHashMap& rhs) noexcept
+    {
+        using std::swap;
+        swap(hash, rhs.hash);
+        swap(equal, rhs.equal);
+        swap_table(rhs);
+    }
+
+    iterator begin() { return {this, next_full(0)}; }
+    iterator end() { return {this, cap}; }
+    const_iterator begin() const { return {this, next_full(0)}; }
+    const_iterator end() const { return {this, cap}; }
+
+    std::size_t size() const { return used; }
+    bool empty() const { return used == 0; }
+    std::size_t capacity() const { return cap; }
+
+    void clear()
+    {
+        for (std::size_t i = 0; i != cap; ++i) {
+            if (ctrl[i] >= 0) {
+                std::destroy_at(&slots[i]);
+            }
+        }
+        std::fill_n(ctrl.get(), cap, _ctrl_empty);
+        used = deleted = 0;
+    }
+
+    // reserve makes room for n elements without rehashing.
+    void reserve(std::size_t n)
+    {
+        if (n > max_load(cap) - deleted) {
+            rehash(capacity_for(n));
+        }
+    }
+
+    iterator find(const Key& key)
+    {
+        return {this, find_index(key)};
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        return {this, find_index(key)};
+    }
+
+    std::size_t count(const Key& key) const
+    {
+        return find_index(key) != cap;
+    }
+
+    T& at(const Key& key)
+    {
+        std::size_t i = find_index(key);
+        if (i == cap) {
+            throw std::out_of_range{"FlatHashMap::at"};
+        }
+        return slots[i].second;
+    }
+
+    const T& at(const Key& key) const
+    {
+        return const_cast<FlatHashMap*>(this)->at(key);
+    }
+
+    T& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v)
+    {
+        return try_emplace(v.first, v.second);
+    }
+
+    // try_emplace constructs T from args when key is not in the map.
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        std::size_t h = _mix_hash(hash(key));
+        std::size_t i = find_index(key, h);
+        if (i != cap) {
+            return {{this, i}, false};
+        }
+        if (used + deleted + 1 > max_load(cap)) {
+            // Rehash in place when tombstones are most of the load.
+            rehash(deleted > used ? cap : capacity_for(used + 1));
+        }
+        i = find_insert_index(h);
+        ::new (static_cast<void*>(&slots[i]))
+            value_type(std::piecewise_construct,
+                       std::forward_as_tuple(std::forward<K>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+        // Count the reused tombstone only once the slot is filled, so that
+        // a throwing constructor leaves the map as it was.
+        deleted -= ctrl[i] == _ctrl_deleted;
+        ctrl[i] = h2(h);
+        ++used;
+        return {{this, i}, true};
+    }
+
+    std::size_t erase(const Key& key)
+    {
+        std::size_t i = find_index(key);
+        if (i == cap) {
+            return 0;
+        }
+        erase_index(i);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        erase_index(pos.i);
+        return {this, next_full(pos.i + 1)};
+    }
+
+private:
+    // Triangular probing over groups: g, g+1, g+3, g+6, ...
+    struct Probe
+    {
+        std::size_t group, mask, step = 0;
+
+        std::size_t offset() const { return group * _group_size; }
+
+        void next()
+        {
+            ++step;
+            group = (group + step) & mask;
+        }
+    };
+
+    static std::int8_t h2(std::size_t h)
+    {
+        return static_cast<std::int8_t>(h & 0x7f);
+    }
+
+    Probe probe(std::size_t h) const
+    {
+        std::size_t mask = cap / _group_size - 1;
+        return {(h >> 7) & mask, mask};
+    }
+
+    // max_load is 7/8 of capacity, counting tombstones.
+    static std::size_t max_load(std::size_t capacity)
+    {
+        return capacity - capacity / 8;
+    }
+
+    static std::size_t capacity_for(std::size_t n)
+    {
+        std::size_t c = _group_size;
+        while (max_load(c) < n) {
+            c *= 2;
+        }
+        return c;
+    }
+
+    std::size_t find_index(const Key& key) const
+    {
+        return cap == 0 ? cap : find_index(key, _mix_hash(hash(key)));
+    }
+
+    // find_index returns the slot of key or cap when not found.
+    template <typename K>
+    std::size_t find_index(const K& key, std::size_t h) const
+    {
+        if (cap == 0) {
+            return cap;
+        }
+        for (Probe p = probe(h); ; p.next()) {
+            _Group g{&ctrl[p.offset()]};
+            for (auto m = g.match(h2(h)); m != 0; m &= m - 1) {
+                std::size_t i = p.offset() + __builtin_ctz(m);
+                if (equal(slots[i].first, key)) {
+                    return i;
+                }
+            }
+            if (g.match_empty() != 0) {
+                return cap;
+            }
+        }
+    }
+
+    // find_insert_index returns the first empty or deleted slot for hash h.
+    std::size_t find_insert_index(std::size_t h) const
+    {
+        for (Probe p = probe(h); ; p.next()) {
+            auto m = _Group{&ctrl[p.offset()]}.match_empty_or_deleted();
+            if (m != 0) {
+                return p.offset() + __builtin_ctz(m);
+            }
+        }
+    }
+
+    void erase_index(std::size_t i)
+    {
+        std::destroy_at(&slots[i]);
+        --used;
+        // A search that reaches a group with an empty slot stops there, so the
+        // slot can be made empty instead of a tombstone in such a group.
+        std::size_t group = i - i % _group_size;
+        if (_Group{&ctrl[group]}.match_empty() != 0) {
+            ctrl[i] = _ctrl_empty;
+        } else {
+            ctrl[i] = _ctrl_deleted;
+            ++deleted;
+        }
+    }
+
+    std::size_t next_full(std::size_t i) const
+    {
+        while (i < cap && ctrl[i] < 0) {
+            ++i;
+        }
+        return i;
+    }
+
+    // rehash moves all elements to a table of new_cap slots, dropping tombstones.
+    void rehash(std::size_t new_cap)
+    {
+        FlatHashMap other{hash, equal, new_cap};
+        for (std::size_t i = 0; i != cap; ++i) {
+            if (ctrl[i] >= 0) {
+                std::size_t h = _mix_hash(hash(slots[i].first));
+                std::size_t j = other.find_insert_index(h);
+                ::new (static_cast<void*>(&other.slots[j])) value_type(std::move(slots[i]));
+                other.ctrl[j] = h2(h);
+                ++other.used;
+            }
+        }
+        swap_table(other);
+    }
+
+    // swap_table swaps all but Hash and KeyEqual, which may be lambdas that
+    // cannot be assigned.
+    void swap_table(FlatHashMap& rhs) noexcept
+    {
+        std::swap(ctrl, rhs.ctrl);
+        std::swap(slots, rhs.slots);
+        std::swap(cap, rhs.cap);
+        std::swap(used, rhs.used);
+        std::swap(deleted, rhs.deleted);
+    }
+
+    // Constructor of an empty table of exactly capacity slots.
+    FlatHashMap(const Hash& hash, const KeyEqual& equal, std::size_t capacity)
+        : hash{hash}, equal{equal},
+          ctrl{new std::int8_t[capacity]},
+          slots{std::allocator<value_type>().allocate(capacity)},
+          cap{capacity}
+    {
+        std::fill_n(ctrl.get(), cap, _ctrl_empty);
+    }
+
+    void destroy()
+    {
+        if (slots != nullptr) {
+            clear();
+            std::allocator<value_type>().deallocate(slots, cap);
+            slots = nullptr;
+        }
+    }
+
+    Hash hash;
+    KeyEqual equal;
+    std::unique_ptr<std::int8_t[]> ctrl;
+    value_type* slots = nullptr;  // Uninitialized storage of cap elements.
+    std::size_t cap = 0;          // 0 or a power of 2 multiple of _group_size.
+    std::size_t used = 0;
+    std::size_t deleted = 0;
+};
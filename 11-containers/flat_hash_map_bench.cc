@@ -0,0 +1,104 @@
+// Benchmark FlatHashMap against std::unordered_map with std::tuple keys.
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "flat_hash_map.h"
+#include "hash_combine.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+using Key = std::tuple<int, int, int>;
+
+// KeyHash hashes the tuple like std::hash<std::tuple> of customhash.cc.
+struct KeyHash
+{
+    std::size_t operator()(const Key& k) const
+    {
+        return std::apply([](const auto&... args) { return hash_combine(args...); }, k);
+    }
+};
+
+using UnorderedMap = std::unordered_map<Key, int, KeyHash>;
+using FlatMap = FlatHashMap<Key, int, KeyHash>;
+
+// make_keys returns n distinct keys in random order, negated when missing so
+// that none of them is among the keys that are not missing.
+std::vector<Key> make_keys(int n, bool missing = false)
+{
+    std::vector<Key> keys;
+    keys.reserve(n);
+    int sign = missing ? -1 : 1;
+    for (int i = 0; i != n; ++i) {
+        keys.emplace_back(sign * (i + 1), i % 1024, i / 1024);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::default_random_engine{});
+    return keys;
+}
+
+template <typename Map>
+Map make_map(const std::vector<Key>& keys)
+{
+    Map m;
+    for (const auto& k : keys) {
+        m[k] = std::get<0>(k);
+    }
+    return m;
+}
+
+template <typename Map>
+void bench_insert(timeit::State& state)
+{
+    auto keys = make_keys(state.arg());
+    while (state.keep_running()) {
+        auto m = make_map<Map>(keys);
+        timeit::do_not_optimize(m);
+    }
+    state.set_items_processed(keys.size());
+}
+
+template <typename Map>
+void bench_lookup(timeit::State& state, bool missing)
+{
+    auto m = make_map<Map>(make_keys(state.arg()));
+    auto keys = make_keys(state.arg(), missing);
+    while (state.keep_running()) {
+        std::size_t found = 0;
+        for (const auto& k : keys) {
+            found += m.find(k) != m.end();
+        }
+        timeit::do_not_optimize(found);
+    }
+    state.set_items_processed(keys.size());
+}
+
+template <typename Map>
+void bench_erase(timeit::State& state)
+{
+    auto keys = make_keys(state.arg());
+    while (state.keep_running()) {
+        state.pause_timing();
+        auto m = make_map<Map>(keys);
+        state.resume_timing();
+        for (const auto& k : keys) {
+            m.erase(k);
+        }
+        timeit::do_not_optimize(m);
+    }
+    state.set_items_processed(keys.size());
+}
+
+#define MAP_SIZES 1'000, 100'000, 10'000'000
+
+TIMEIT_BENCHMARK_ARGS("[insert:std::unordered_map]", MAP_SIZES) { bench_insert<UnorderedMap>(state); }
+TIMEIT_BENCHMARK_ARGS("[insert:FlatHashMap]", MAP_SIZES) { bench_insert<FlatMap>(state); }
+TIMEIT_BENCHMARK_ARGS("[lookup:hit:std::unordered_map]", MAP_SIZES) { bench_lookup<UnorderedMap>(state, false); }
+TIMEIT_BENCHMARK_ARGS("[lookup:hit:FlatHashMap]", MAP_SIZES) { bench_lookup<FlatMap>(state, false); }
+TIMEIT_BENCHMARK_ARGS("[lookup:miss:std::unordered_map]", MAP_SIZES) { bench_lookup<UnorderedMap>(state, true); }
+TIMEIT_BENCHMARK_ARGS("[lookup:miss:FlatHashMap]", MAP_SIZES) { bench_lookup<FlatMap>(state, true); }
+TIMEIT_BENCHMARK_ARGS("[erase:std::unordered_map]", MAP_SIZES) { bench_erase<UnorderedMap>(state); }
+TIMEIT_BENCHMARK_ARGS("[erase:FlatHashMap]", MAP_SIZES) { bench_erase<FlatMap>(state); }
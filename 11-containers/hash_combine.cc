@@ -1,62 +1,18 @@
 // Demonstrate combining hash functions.
+#include <algorithm>
+#include <bitset>
 #include <cstddef>
-#include <functional>
-#include <iterator>
+#include <cstdint>
+#include <list>
+#include <numeric>
+#include <string>
 #include <vector>
 
+#include "hash_combine.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-template<class>
-constexpr bool dependent_false = false;
-
-template <typename T>
-inline void _hash_combine(std::size_t& seed, const T& val)
-{
-    // Magic numbers in boost::hash_combine assume sizeof(size_t) == 4
-    // Extend support to sizeof(size_t) == 8 based on
-    // https://github.com/HowardHinnant/hash_append/issues/7
-    if constexpr (sizeof(std::size_t) == 4) {
-        seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-    }
-    else if constexpr (sizeof(std::size_t) == 8) {
-        seed ^= std::hash<T>()(val) + 0x9e3779b97f4a7c15LLU + (seed<<12) +
-            (seed>>4);
-    }
-    else {
-        static_assert(dependent_false<T>, "hash_combine not supported");
-    }
-}
-
-template <typename... Types>
-std::size_t hash_combine(const Types&... args)
-{
-    // Copy-paste of
-    // https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2018/p0814r2.pdf
-    std::size_t seed = 0;
-    (_hash_combine(seed, args), ...); // Fold expression with seed over args.
-    return seed;
-}
-
-template <class, class Enable = void>
-struct is_iterator : std::false_type {};
-
-template <typename T>
-struct is_iterator<T, typename std::enable_if<std::is_pointer<typename
-     std::iterator_traits<T>::pointer>::value>::type> : std::true_type {};
-
-// Overload when is_iterator<T> is true.
-template <typename InputIterator,
-          std::enable_if_t<is_iterator<std::decay_t<InputIterator>>{}>* = nullptr>
-std::size_t hash_combine(InputIterator first, InputIterator last)
-{
-    std::size_t seed = 0;
-    while (first != last) {
-        _hash_combine(seed, *first++);
-    }
-    return seed;
-}
-
 TEST_CASE("[hash_combine]")
 {
     SUBCASE("noncommutative")
@@ -87,4 +43,63 @@ TEST_CASE("[hash_combine]")
         int *p1 = v1.data(), *p2 = v1.data() + v1.size();
         REQUIRE(hash_combine(p1, p2) == hash_combine(i1, i2, i3));
     }
+
+    SUBCASE("bulk")
+    {
+        // Contiguous ranges hashed in bulk agree with hashing one at a time,
+        // for lengths around the blocks of 32 words.
+        std::vector<std::int32_t> v1(100);
+        std::iota(v1.begin(), v1.end(), -50);
+        std::vector<std::uint32_t> v2(v1.begin(), v1.end());
+        std::vector<std::int64_t> v3(v1.begin(), v1.end());
+        for (std::size_t n = 0; n != v1.size(); ++n) {
+            std::list<std::int32_t> l1(v1.begin(), v1.begin() + n);
+            auto h1 = hash_combine(l1.begin(), l1.end());
+            REQUIRE(hash_combine(v1.begin(), v1.begin() + n) == h1);
+            REQUIRE(hash_combine(v1.data(), v1.data() + n) == h1);
+            // Signed integers are sign extended to 64 bits.
+            REQUIRE(hash_combine(v3.cbegin(), v3.cbegin() + n) == h1);
+
+            std::list<std::uint32_t> l2(v2.begin(), v2.begin() + n);
+            REQUIRE(hash_combine(v2.begin(), v2.begin() + n) ==
+                    hash_combine(l2.begin(), l2.end()));
+        }
+
+        // Other types are hashed by std::hash.
+        std::vector<std::string> v4{"one", "two"};
+        REQUIRE(hash_combine(v4.begin(), v4.end()) ==
+                hash_combine(std::string{"one"}, std::string{"two"}));
+    }
+
+    SUBCASE("avalanche")
+    {
+        // Flipping any bit of the input flips about half of the output bits,
+        // where boost_hash_combine flips a handful.
+        auto flips = [](auto hash) {
+            std::size_t min_flips = 64;
+            for (std::uint64_t x = 0; x != 64; ++x) {
+                for (int bit = 0; bit != 64; ++bit) {
+                    auto h1 = hash(x, std::uint64_t{1}), h2 = hash(x ^ (1ULL << bit), std::uint64_t{1});
+                    min_flips = std::min(min_flips, std::bitset<64>(h1 ^ h2).count());
+                }
+            }
+            return min_flips;
+        };
+        REQUIRE(flips([](auto x, auto y) { return hash_combine(x, y); }) >= 12);
+        REQUIRE(flips([](auto x, auto y) { return boost_hash_combine(x, y); }) < 12);
+    }
+
+    SUBCASE("low bits")
+    {
+        // Small integer tuples spread over the buckets of a power of two table.
+        constexpr std::size_t num_buckets = 1024;
+        std::vector<int> buckets(num_buckets);
+        for (int x = 0; x != 64; ++x) {
+            for (int y = 0; y != 64; ++y) {
+                ++buckets[hash_combine(x, y, 0) % num_buckets];
+            }
+        }
+        // 4 expected per bucket.
+        REQUIRE(*std::max_element(buckets.begin(), buckets.end()) <= 16);
+    }
 }
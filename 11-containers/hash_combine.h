@@ -0,0 +1,263 @@
+// Combine std::hash values of many objects into a single hash.
+//
+// hash_combine turns each object into a 64-bit word, integers as they are and
+// other types by std::hash, and accumulates the words in 4 lanes in the manner
+// of xxh3: a word is xored with a key chosen by its position, the product of
+// the low and high halves of the result is added to the lane of the word, and
+// every 32 words the lanes are scrambled. The lanes and the length are then
+// mixed by a 64-bit finalizer, so every input bit affects every output bit.
+// boost_hash_combine, which folds std::hash values into a seed, leaves the
+// identity std::hash of integers nearly unmixed, so tuples of small integers
+// cluster in the low bits used by power of two tables. The lanes of
+// hash_combine are independent, so contiguous ranges of integers are hashed 4
+// words at a time with AVX2.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../06-templates/execution.h"
+
+template<class>
+constexpr bool dependent_false = false;
+
+// _hash_mix64 is the 64-bit finalizer of splitmix64, of which every output
+// bit depends on every input bit.
+constexpr std::uint64_t _hash_mix64(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+constexpr std::size_t _hash_lanes = 4;
+constexpr std::size_t _hash_block = 32; // Words between scrambles.
+
+// _HashKeys are the keys xored with words by position, from splitmix64.
+struct _HashKeys
+{
+    constexpr _HashKeys()
+    {
+        std::uint64_t x = 0;
+        for (auto& k : keys) {
+            x += 0x9e3779b97f4a7c15ULL;
+            k = _hash_mix64(x);
+        }
+    }
+
+    std::uint64_t keys[_hash_block + 2 * _hash_lanes] = {};
+};
+
+inline constexpr _HashKeys _hash_keys{};
+
+// _hash_word is the 64-bit word hashed for val.
+template <typename T>
+std::uint64_t _hash_word(const T& val)
+{
+    if constexpr (std::is_integral_v<T>) {
+        // Sign extends signed integers.
+        return static_cast<std::uint64_t>(val);
+    }
+    else {
+        return std::hash<T>()(val);
+    }
+}
+
+// _HashState accumulates words into the lanes of hash_combine.
+class _HashState
+{
+public:
+    void add(std::uint64_t w)
+    {
+        std::uint64_t d = w ^ _hash_keys.keys[n % _hash_block];
+        acc[n % _hash_lanes] += (d & 0xffffffff) * (d >> 32) + w;
+        if (++n % _hash_block == 0) {
+            scramble();
+        }
+    }
+
+    // add hashes the words of count elements starting at p.
+    template <typename T>
+    void add(const T* p, std::size_t count)
+    {
+        const T* last = p + count;
+#if defined(__AVX2__)
+        if constexpr (std::is_integral_v<T> && (sizeof(T) == 4 || sizeof(T) == 8)) {
+            // Align to a block with the scalar loop.
+            while (p != last && n % _hash_block != 0) {
+                add(_hash_word(*p++));
+            }
+            if (static_cast<std::size_t>(last - p) >= _hash_block) {
+                std::size_t num_blocks = (last - p) / _hash_block;
+                add_blocks(p, num_blocks);
+                p += num_blocks * _hash_block;
+                n += num_blocks * _hash_block;
+            }
+        }
+#endif
+        while (p != last) {
+            add(_hash_word(*p++));
+        }
+    }
+
+    std::uint64_t finish() const
+    {
+        // The lanes are mixed independently, so the mixes overlap.
+        std::uint64_t h = _hash_mix64(acc[0] ^ _hash_keys.keys[_hash_block] ^ n);
+        for (std::size_t l = 1; l != _hash_lanes; ++l) {
+            auto m = _hash_mix64(acc[l] ^ _hash_keys.keys[_hash_block + l]);
+            h += (m << (16 * l)) | (m >> (64 - 16 * l));
+        }
+        return h;
+    }
+
+private:
+    static constexpr std::uint64_t prime32 = 0x9e3779b1;
+
+    // scramble folds the high bits of the lanes into the low bits, which the
+    // 32-bit products of add have not reached, and remixes them.
+    void scramble()
+    {
+        for (std::size_t l = 0; l != _hash_lanes; ++l) {
+            acc[l] = (acc[l] ^ (acc[l] >> 47) ^ _hash_keys.keys[l]) * prime32;
+        }
+    }
+
+#if defined(__AVX2__)
+    // load4 loads 4 integers starting at p into 64-bit lanes like _hash_word.
+    template <typename T>
+    static __m256i load4(const T* p)
+    {
+        if constexpr (sizeof(T) == 8) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+        else if constexpr (std::is_signed_v<T>) {
+            return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        }
+        else {
+            return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        }
+    }
+
+    // add_blocks adds num_blocks blocks of words, each a word per lane at a
+    // time, starting at p.
+    template <typename T>
+    void add_blocks(const T* p, std::size_t num_blocks)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc));
+        const __m256i scramble_keys = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(_hash_keys.keys));
+        const __m256i prime = _mm256_set1_epi64x(prime32);
+        for (std::size_t b = 0; b != num_blocks; ++b, p += _hash_block) {
+            for (std::size_t i = 0; i != _hash_block; i += _hash_lanes) {
+                __m256i w = load4(p + i);
+                __m256i k = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(_hash_keys.keys + i));
+                __m256i d = _mm256_xor_si256(w, k);
+                // _mm256_mul_epu32 multiplies the low halves of the lanes.
+                __m256i prod = _mm256_mul_epu32(d, _mm256_srli_epi64(d, 32));
+                a = _mm256_add_epi64(a, _mm256_add_epi64(prod, w));
+            }
+            a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+            a = _mm256_xor_si256(a, scramble_keys);
+            // 64 by 32-bit multiply from the products of both halves.
+            __m256i lo = _mm256_mul_epu32(a, prime);
+            __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+            a = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), a);
+    }
+#endif
+
+    std::uint64_t acc[_hash_lanes] = {
+        _hash_keys.keys[_hash_block + 4], _hash_keys.keys[_hash_block + 5],
+        _hash_keys.keys[_hash_block + 6], _hash_keys.keys[_hash_block + 7]
+    };
+    std::uint64_t n = 0; // Words added.
+};
+
+template <typename... Types>
+std::size_t hash_combine(const Types&... args)
+{
+    _HashState state;
+    (state.add(_hash_word(args)), ...); // Fold expression over args.
+    return state.finish();
+}
+
+template <class, class Enable = void>
+struct is_iterator : std::false_type {};
+
+template <typename T>
+struct is_iterator<T, typename std::enable_if<std::is_pointer<typename
+     std::iterator_traits<T>::pointer>::value>::type> : std::true_type {};
+
+// Overload when is_iterator<T> is true.
+template <typename InputIterator,
+          std::enable_if_t<is_iterator<std::decay_t<InputIterator>>{}>* = nullptr>
+std::size_t hash_combine(InputIterator first, InputIterator last)
+{
+    _HashState state;
+    if constexpr (mystd::_is_contiguous_iterator<std::decay_t<InputIterator>>) {
+        if (first != last) {
+            state.add(std::addressof(*first), std::distance(first, last));
+        }
+    }
+    else {
+        while (first != last) {
+            state.add(_hash_word(*first++));
+        }
+    }
+    return state.finish();
+}
+
+template <typename T>
+inline void _boost_hash_combine(std::size_t& seed, const T& val)
+{
+    // Magic numbers in boost::hash_combine assume sizeof(size_t) == 4
+    // Extend support to sizeof(size_t) == 8 based on
+    // https://github.com/HowardHinnant/hash_append/issues/7
+    if constexpr (sizeof(std::size_t) == 4) {
+        seed ^= std::hash<T>()(val) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+    }
+    else if constexpr (sizeof(std::size_t) == 8) {
+        seed ^= std::hash<T>()(val) + 0x9e3779b97f4a7c15LLU + (seed<<12) +
+            (seed>>4);
+    }
+    else {
+        static_assert(dependent_false<T>, "hash_combine not supported");
+    }
+}
+
+// boost_hash_combine is the boost::hash_combine fold that hash_combine replaces.
+template <typename... Types>
+std::size_t boost_hash_combine(const Types&... args)
+{
+    // Copy-paste of
+    // https://www.open-std.org/jtc1/sc22/wg21/docs/papers/2018/p0814r2.pdf
+    std::size_t seed = 0;
+    (_boost_hash_combine(seed, args), ...); // Fold expression with seed over args.
+    return seed;
+}
+
+template <typename InputIterator,
+          std::enable_if_t<is_iterator<std::decay_t<InputIterator>>{}>* = nullptr>
+std::size_t boost_hash_combine(InputIterator first, InputIterator last)
+{
+    std::size_t seed = 0;
+    while (first != last) {
+        _boost_hash_combine(seed, *first++);
+    }
+    return seed;
+}
@@ -0,0 +1,131 @@
+// Benchmark hash_combine over variadic arguments and iterator ranges.
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "hash_combine.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// ref_cycles reads the time stamp counter where available, else returns 0.
+// The counter ticks at a constant reference rate, not at the clock of the
+// core, which varies with turbo and power saving.
+inline std::uint64_t ref_cycles()
+{
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// set_bytes_per_ref_cycle reports the bytes hashed per reference cycle of
+// the timed loop.
+void set_bytes_per_ref_cycle(timeit::State& state, double bytes, std::uint64_t start)
+{
+    std::uint64_t elapsed = ref_cycles() - start;
+    if (elapsed != 0) {
+        state.counters["bytes/ref_cycle"] = bytes / elapsed;
+    }
+}
+
+// set_avalanche reports how often flipping an input bit of a triple of
+// integers flips an output bit, ideally 0.5 for every pair of bits. bias is
+// the mean and worst the largest distance from 0.5 over all pairs. It hashes
+// 193k triples, so it is called once per benchmark, outside the timed loop.
+template <typename Hash>
+void set_avalanche(timeit::State& state, Hash hash)
+{
+    constexpr int num_inputs = 1000, num_bits = 3 * 64;
+    std::vector<std::int64_t> flips(num_bits * 64);
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<std::int64_t> dist{0, 1 << 20}; // Small keys.
+    for (int n = 0; n != num_inputs; ++n) {
+        std::uint64_t x[3] = {std::uint64_t(dist(gen)), std::uint64_t(dist(gen)),
+                              std::uint64_t(dist(gen))};
+        auto h = hash(x[0], x[1], x[2]);
+        for (int i = 0; i != num_bits; ++i) {
+            x[i / 64] ^= 1ULL << i % 64;
+            std::bitset<64> diff = h ^ hash(x[0], x[1], x[2]);
+            x[i / 64] ^= 1ULL << i % 64;
+            for (int j = 0; j != 64; ++j) {
+                flips[i * 64 + j] += diff[j];
+            }
+        }
+    }
+    double bias = 0, worst = 0;
+    for (auto f : flips) {
+        double d = std::abs(static_cast<double>(f) / num_inputs - 0.5);
+        bias += d / flips.size();
+        worst = std::max(worst, d);
+    }
+    state.counters["bias"] = bias;
+    state.counters["worst"] = worst;
+}
+
+template <typename Hash>
+void bench_args(timeit::State& state, Hash hash)
+{
+    std::int64_t x = 1, y = 2, z = 3;
+    std::int64_t num_iter = 0;
+    auto start = ref_cycles();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(x);
+        timeit::do_not_optimize(hash(x, y, z));
+        ++num_iter;
+    }
+    set_bytes_per_ref_cycle(state, num_iter * 3. * sizeof(x), start);
+    set_avalanche(state, hash);
+    state.set_bytes_processed(3 * sizeof(x));
+}
+
+template <typename T, typename Hash>
+void bench_range(timeit::State& state, Hash hash)
+{
+    std::vector<T> v(state.arg());
+    std::iota(v.begin(), v.end(), 0);
+    std::int64_t num_iter = 0;
+    auto start = ref_cycles();
+    while (state.keep_running()) {
+        timeit::do_not_optimize(hash(v.begin(), v.end()));
+        ++num_iter;
+    }
+    set_bytes_per_ref_cycle(state, num_iter * 1. * v.size() * sizeof(v[0]), start);
+    state.set_bytes_processed(v.size() * sizeof(v[0]));
+}
+
+TIMEIT_BENCHMARK("[hash_combine:args]")
+{
+    bench_args(state, [](auto... args) { return hash_combine(args...); });
+}
+
+TIMEIT_BENCHMARK("[boost_hash_combine:args]")
+{
+    bench_args(state, [](auto... args) { return boost_hash_combine(args...); });
+}
+
+#define RANGE_SIZES 16, 1'024, 65'536
+
+TIMEIT_BENCHMARK_ARGS("[hash_combine:range]", RANGE_SIZES)
+{
+    bench_range<std::int64_t>(state, [](auto first, auto last) { return hash_combine(first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[hash_combine:range:int32]", RANGE_SIZES)
+{
+    bench_range<std::int32_t>(state, [](auto first, auto last) { return hash_combine(first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[boost_hash_combine:range]", RANGE_SIZES)
+{
+    bench_range<std::int64_t>(state, [](auto first, auto last) { return boost_hash_combine(first, last); });
+}
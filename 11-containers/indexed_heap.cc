@@ -0,0 +1,116 @@
+// Demonstrate an indexed d-ary heap with decrease_key.
+#include <functional>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "indexed_heap.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+// check_heap applies random operations to a MinIndexedHeap and to a map from
+// handle to value, and checks that they agree.
+template <std::size_t D>
+void check_heap()
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> value{0, 1000};
+    std::uniform_int_distribution<int> op{0, 4};
+    MinIndexedHeap<int, std::less<int>, D> heap;
+    std::map<std::size_t, int> expected;
+    auto random_handle = [&] {
+        auto it = std::begin(expected);
+        std::advance(it, std::uniform_int_distribution<std::size_t>{0, expected.size() - 1}(gen));
+        return it->first;
+    };
+    for (int n = 0; n != 20'000; ++n) {
+        int v = value(gen);
+        switch (expected.empty() ? 0 : op(gen)) {
+        case 0:
+            expected[heap.push(v)] = v;
+            break;
+        case 1: {
+            auto h = random_handle();
+            expected[h] = std::min(v, expected[h]);
+            heap.decrease_key(h, expected[h]);
+            break;
+        }
+        case 2: {
+            auto h = random_handle();
+            expected[h] = std::max(v, expected[h]);
+            heap.increase_key(h, expected[h]);
+            break;
+        }
+        case 3: {
+            auto h = random_handle();
+            heap.erase(h);
+            expected.erase(h);
+            break;
+        }
+        case 4: {
+            auto h = heap.top_handle();
+            REQUIRE(expected[h] == heap.top());
+            heap.pop();
+            expected.erase(h);
+            break;
+        }
+        }
+        REQUIRE(heap.size() == expected.size());
+    }
+    for (const auto& [h, v] : expected) {
+        REQUIRE(heap.value(h) == v);
+    }
+    // Elements pop in order.
+    int prev = -1;
+    while (!heap.empty()) {
+        REQUIRE(prev <= heap.top());
+        prev = heap.top();
+        heap.pop();
+    }
+}
+
+TEST_CASE("[MinIndexedHeap]")
+{
+    SUBCASE("top is least")
+    {
+        MinIndexedHeap<int> heap;
+        auto h1 = heap.push(3);
+        auto h2 = heap.push(1);
+        auto h3 = heap.push(2);
+        REQUIRE(heap.top() == 1);
+        REQUIRE(heap.top_handle() == h2);
+
+        // Change the priority of elements in place.
+        heap.decrease_key(h1, 0);
+        REQUIRE(heap.top_handle() == h1);
+        heap.increase_key(h1, 4);
+        REQUIRE(heap.top_handle() == h2);
+        heap.update(h3, 0);
+        REQUIRE(heap.top_handle() == h3);
+
+        heap.erase(h2);
+        REQUIRE_FALSE(heap.contains(h2));
+        REQUIRE(heap.size() == 2);
+        heap.pop();
+        REQUIRE(heap.top() == 4);
+    }
+
+    SUBCASE("invalid")
+    {
+        MinIndexedHeap<int> heap;
+        auto h = heap.push(1);
+        REQUIRE_THROWS_AS(heap.decrease_key(h, 2), std::invalid_argument);
+        REQUIRE_THROWS_AS(heap.increase_key(h, 0), std::invalid_argument);
+        heap.pop();
+        REQUIRE_THROWS_AS(heap.value(h), std::out_of_range);
+        REQUIRE_THROWS_AS(heap.erase(h), std::out_of_range);
+    }
+
+    SUBCASE("random operations:binary") { check_heap<2>(); }
+    SUBCASE("random operations:4-ary") { check_heap<4>(); }
+    SUBCASE("random operations:8-ary") { check_heap<8>(); }
+}
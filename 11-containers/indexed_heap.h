@@ -0,0 +1,227 @@
+// Indexed d-ary heap supporting decrease_key, increase_key and erase.
+//
+// std::priority_queue cannot find an element once pushed, so the only way to
+// change its priority is to push a duplicate and skip the stale entry when it
+// reaches the top. MinIndexedHeap returns a handle from push, and keeps the
+// position in the heap of every handle up to date as elements move, so the
+// element of a handle can be updated or erased in place. Each node has D
+// children, which makes the heap shallower than a binary heap and puts the
+// children of a node next to each other in memory: a pop compares more
+// elements per level but touches fewer cache lines.
+//
+// Unlike std::priority_queue, and like the textbook heaps with decrease_key,
+// top is the least element under Compare, hence the name: code written for
+// std::priority_queue does not silently pop in the opposite order.
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename T, typename Compare = std::less<T>, std::size_t D = 4>
+class MinIndexedHeap
+{
+    static_assert(D >= 2, "MinIndexedHeap requires at least 2 children");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using handle = std::size_t; // Valid until its element is popped or erased.
+
+    explicit MinIndexedHeap(const Compare& comp = Compare())
+        : comp{comp}
+    { }
+
+    bool empty() const { return heap.empty(); }
+    std::size_t size() const { return heap.size(); }
+
+    void reserve(std::size_t n)
+    {
+        heap.reserve(n);
+        position.reserve(n);
+    }
+
+    void clear()
+    {
+        heap.clear();
+        position.clear();
+        free_handles.clear();
+    }
+
+    const T& top() const { return heap.front().value; }
+    handle top_handle() const { return heap.front().h; }
+
+    handle push(const T& value) { return emplace(value); }
+    handle push(T&& value) { return emplace(std::move(value)); }
+
+    template <typename... Args>
+    handle emplace(Args&&... args)
+    {
+        handle h;
+        if (free_handles.empty()) {
+            h = position.size();
+            position.push_back(heap.size());
+        }
+        else {
+            h = free_handles.back();
+            free_handles.pop_back();
+            position[h] = heap.size();
+        }
+        heap.push_back({T(std::forward<Args>(args)...), h});
+        sift_up(heap.size() - 1);
+        return h;
+    }
+
+    void pop()
+    {
+        erase_at(0);
+    }
+
+    // contains is true when h is the handle of an element in the heap.
+    bool contains(handle h) const
+    {
+        return h < position.size() && position[h] != npos;
+    }
+
+    // value returns the element of h, std::out_of_range if none.
+    const T& value(handle h) const
+    {
+        return heap[checked_position(h)].value;
+    }
+
+    // decrease_key replaces the element of h with one that is not greater,
+    // moving it toward the top. std::invalid_argument if value is greater.
+    void decrease_key(handle h, T value)
+    {
+        auto i = checked_position(h);
+        if (comp(heap[i].value, value)) {
+            throw std::invalid_argument{"MinIndexedHeap::decrease_key: greater value"};
+        }
+        heap[i].value = std::move(value);
+        sift_up(i);
+    }
+
+    // increase_key replaces the element of h with one that is not less,
+    // moving it away from the top. std::invalid_argument if value is less.
+    void increase_key(handle h, T value)
+    {
+        auto i = checked_position(h);
+        if (comp(value, heap[i].value)) {
+            throw std::invalid_argument{"MinIndexedHeap::increase_key: lesser value"};
+        }
+        heap[i].value = std::move(value);
+        sift_down(i);
+    }
+
+    // update replaces the element of h with any value.
+    void update(handle h, T value)
+    {
+        auto i = checked_position(h);
+        bool less = comp(value, heap[i].value);
+        heap[i].value = std::move(value);
+        less ? sift_up(i) : sift_down(i);
+    }
+
+    // erase removes the element of h, std::out_of_range if none.
+    void erase(handle h)
+    {
+        erase_at(checked_position(h));
+    }
+
+private:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    struct Entry
+    {
+        T value;
+        handle h;
+    };
+
+    std::size_t checked_position(handle h) const
+    {
+        if (!contains(h)) {
+            throw std::out_of_range{"MinIndexedHeap: invalid handle"};
+        }
+        return position[h];
+    }
+
+    // erase_at replaces the element at i with the last one and restores the
+    // heap around it.
+    void erase_at(std::size_t i)
+    {
+        position[heap[i].h] = npos;
+        free_handles.push_back(heap[i].h);
+        if (i + 1 != heap.size()) {
+            heap[i] = std::move(heap.back());
+            position[heap[i].h] = i;
+            heap.pop_back();
+            if (i != 0 && comp(heap[i].value, heap[(i - 1) / D].value)) {
+                sift_up(i);
+            }
+            else {
+                sift_down(i);
+            }
+        }
+        else {
+            heap.pop_back();
+        }
+    }
+
+    // sift_up moves the element at i toward the root while it is less than
+    // its parent. The element is held aside while the parents move down.
+    void sift_up(std::size_t i)
+    {
+        Entry e = std::move(heap[i]);
+        while (i != 0) {
+            std::size_t parent = (i - 1) / D;
+            if (!comp(e.value, heap[parent].value)) {
+                break;
+            }
+            place(i, std::move(heap[parent]));
+            i = parent;
+        }
+        place(i, std::move(e));
+    }
+
+    // sift_down moves the element at i toward the leaves while its least
+    // child is less than it.
+    void sift_down(std::size_t i)
+    {
+        std::size_t n = heap.size();
+        Entry e = std::move(heap[i]);
+        for (;;) {
+            std::size_t first = D * i + 1;
+            if (first >= n) {
+                break;
+            }
+            std::size_t last = first + D < n ? first + D : n;
+            std::size_t least = first;
+            for (std::size_t c = first + 1; c < last; ++c) {
+                if (comp(heap[c].value, heap[least].value)) {
+                    least = c;
+                }
+            }
+            if (!comp(heap[least].value, e.value)) {
+                break;
+            }
+            place(i, std::move(heap[least]));
+            i = least;
+        }
+        place(i, std::move(e));
+    }
+
+    void place(std::size_t i, Entry&& e)
+    {
+        position[e.h] = i;
+        heap[i] = std::move(e);
+    }
+
+    Compare comp;
+    std::vector<Entry> heap;
+    std::vector<std::size_t> position; // Index in heap of each handle.
+    std::vector<handle> free_handles;
+};
@@ -0,0 +1,127 @@
+// Benchmark Dijkstra with MinIndexedHeap against std::priority_queue.
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "indexed_heap.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Graph is a directed graph in compressed sparse row form: the edges of
+// vertex v are edges[first[v]] up to edges[first[v+1]].
+struct Graph
+{
+    struct Edge
+    {
+        int to;
+        std::int64_t weight;
+    };
+    std::vector<std::size_t> first;
+    std::vector<Edge> edges;
+};
+
+// make_graph returns a random graph of n vertices with degree edges each,
+// including an edge to the next vertex so every vertex is reachable.
+Graph make_graph(int n, int degree = 8)
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<int> to{0, n - 1};
+    std::uniform_int_distribution<std::int64_t> weight{1, 1000};
+    Graph g;
+    g.first.push_back(0);
+    for (int v = 0; v != n; ++v) {
+        g.edges.push_back({(v + 1) % n, weight(gen)});
+        for (int i = 1; i != degree; ++i) {
+            g.edges.push_back({to(gen), weight(gen)});
+        }
+        g.first.push_back(g.edges.size());
+    }
+    return g;
+}
+
+constexpr auto infinity = std::numeric_limits<std::int64_t>::max();
+
+using Entry = std::pair<std::int64_t, int>; // Distance and vertex.
+
+// dijkstra_lazy pushes a vertex again whenever its distance shrinks, and skips
+// the stale entries on pop.
+std::vector<std::int64_t> dijkstra_lazy(const Graph& g, int source, std::int64_t& num_pops)
+{
+    std::vector<std::int64_t> dist(g.first.size() - 1, infinity);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    dist[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty()) {
+        auto [d, v] = queue.top();
+        queue.pop();
+        ++num_pops;
+        if (d != dist[v]) {
+            continue; // Stale.
+        }
+        for (auto e = g.first[v]; e != g.first[v + 1]; ++e) {
+            auto [to, weight] = g.edges[e];
+            if (d + weight < dist[to]) {
+                dist[to] = d + weight;
+                queue.emplace(dist[to], to);
+            }
+        }
+    }
+    return dist;
+}
+
+// dijkstra_indexed keeps one entry per vertex and lowers it in place.
+template <std::size_t D>
+std::vector<std::int64_t> dijkstra_indexed(const Graph& g, int source, std::int64_t& num_pops)
+{
+    using Heap = MinIndexedHeap<Entry, std::less<Entry>, D>;
+    std::vector<std::int64_t> dist(g.first.size() - 1, infinity);
+    std::vector<typename Heap::handle> handles(dist.size());
+    Heap heap;
+    dist[source] = 0;
+    handles[source] = heap.push({0, source});
+    while (!heap.empty()) {
+        auto [d, v] = heap.top();
+        heap.pop();
+        ++num_pops;
+        for (auto e = g.first[v]; e != g.first[v + 1]; ++e) {
+            auto [to, weight] = g.edges[e];
+            if (d + weight < dist[to]) {
+                bool queued = dist[to] != infinity;
+                dist[to] = d + weight;
+                if (queued) {
+                    heap.decrease_key(handles[to], {dist[to], to});
+                }
+                else {
+                    handles[to] = heap.push({dist[to], to});
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+template <typename Func>
+void bench_dijkstra(timeit::State& state, Func dijkstra)
+{
+    auto g = make_graph(state.arg());
+    std::int64_t num_pops = 0;
+    while (state.keep_running()) {
+        num_pops = 0;
+        timeit::do_not_optimize(dijkstra(g, 0, num_pops));
+    }
+    state.counters["pops/vertex"] = static_cast<double>(num_pops) / state.arg();
+    state.set_items_processed(g.edges.size());
+}
+
+#define GRAPH_SIZES 10'000, 100'000, 1'000'000
+
+TIMEIT_BENCHMARK_ARGS("[dijkstra:std::priority_queue]", GRAPH_SIZES) { bench_dijkstra(state, dijkstra_lazy); }
+TIMEIT_BENCHMARK_ARGS("[dijkstra:MinIndexedHeap<2>]", GRAPH_SIZES) { bench_dijkstra(state, dijkstra_indexed<2>); }
+TIMEIT_BENCHMARK_ARGS("[dijkstra:MinIndexedHeap<4>]", GRAPH_SIZES) { bench_dijkstra(state, dijkstra_indexed<4>); }
+TIMEIT_BENCHMARK_ARGS("[dijkstra:MinIndexedHeap<8>]", GRAPH_SIZES) { bench_dijkstra(state, dijkstra_indexed<8>); }
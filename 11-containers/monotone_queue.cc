@@ -0,0 +1,97 @@
+// Demonstrate priority queues of monotone integer keys.
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "monotone_queue.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+using namespace std::string_literals; // Required.
+
+// check_queue runs the hold model of a timer queue, popping the earliest
+// timer and pushing a later one, against std::priority_queue.
+template <typename Queue, typename Key>
+void check_queue(Key start, Key max_delay)
+{
+    using Entry = std::pair<Key, int>;
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<Key> delay{0, max_delay};
+    std::uniform_int_distribution<int> grow{0, 2};
+    Queue queue;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> expected;
+    for (int i = 0; i != 100; ++i) {
+        Key key = start + delay(gen);
+        queue.push({key, i});
+        expected.push({key, i});
+    }
+    for (int i = 0; i != 50'000; ++i) {
+        // The queue grows, shrinks and empties over time.
+        int n = i < 20'000 ? grow(gen) : i < 40'000 ? grow(gen) % 2 : 0;
+        Key now = expected.empty() ? start : expected.top().first;
+        if (!expected.empty()) {
+            REQUIRE(queue.top().first == now);
+            queue.pop();
+            expected.pop();
+        }
+        for (int j = 0; j != n; ++j) {
+            Key key = now + delay(gen);
+            queue.push({key, i});
+            expected.push({key, i});
+        }
+        REQUIRE(queue.size() == expected.size());
+    }
+}
+
+TEST_CASE("[monotone_queue]")
+{
+    SUBCASE("RadixHeap")
+    {
+        RadixHeap<int, std::string> queue;
+        queue.push({3, "three"s});
+        queue.push({1, "one"s});
+        queue.emplace(2, "two"s);
+        REQUIRE(queue.top() == std::pair{1, "one"s});
+        queue.pop();
+        REQUIRE(queue.top().second == "two"s);
+
+        // Keys must not decrease below the last top.
+        REQUIRE_THROWS_AS(queue.push({1, "one"s}), std::invalid_argument);
+        queue.push({2, "two again"s});
+        REQUIRE(queue.size() == 3);
+    }
+
+    SUBCASE("CalendarQueue")
+    {
+        CalendarQueue<int, std::string> queue;
+        queue.push({3, "three"s});
+        queue.push({1, "one"s});
+        queue.emplace(2, "two"s);
+        REQUIRE(queue.top() == std::pair{1, "one"s});
+        queue.pop();
+        REQUIRE(queue.top().second == "two"s);
+        REQUIRE_THROWS_AS(queue.push({1, "one"s}), std::invalid_argument);
+        queue.pop();
+        queue.pop();
+        REQUIRE(queue.empty());
+
+        // An empty queue accepts any key.
+        queue.push({-5, "minus five"s});
+        REQUIRE(queue.top().first == -5);
+    }
+
+    SUBCASE("hold model")
+    {
+        check_queue<RadixHeap<std::uint64_t, int>>(std::uint64_t{0}, std::uint64_t{1000});
+        check_queue<RadixHeap<std::int32_t, int>>(-1'000'000, 100);
+        check_queue<CalendarQueue<std::uint64_t, int>>(std::uint64_t{0}, std::uint64_t{1000});
+        check_queue<CalendarQueue<std::int32_t, int>>(-1'000'000, 100);
+        check_queue<CalendarQueue<std::int64_t, int>>(std::int64_t{1} << 40, std::int64_t{1} << 30);
+    }
+}
@@ -0,0 +1,240 @@
+// Priority queues of integer keys that never decrease, as for timers.
+//
+// When no key pushed is less than the last key popped, as for the deadlines
+// of timers and the distances of Dijkstra, the queue need not be a
+// comparison heap. RadixHeap files each element in the bucket of the highest
+// bit in which its key differs from the last key popped, so an element moves
+// only to lower buckets, at most once per bit of the key. CalendarQueue, of
+// Brown, "Calendar Queues", 1988, files each element in the bucket of its
+// "day" in a year of buckets, like a desk calendar, and resizes the year to
+// keep a few elements per day, so push and pop are amortized O(1).
+//
+// Both have the push, top and pop of std::priority_queue, with top the element
+// of least key. Keys pushed must not be less than the key of the last top or
+// pop since the queue was last empty, std::invalid_argument otherwise.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// _ordered_bits maps integer keys to unsigned integers in the same order.
+template <typename Key>
+std::make_unsigned_t<Key> _ordered_bits(Key key)
+{
+    static_assert(std::is_integral_v<Key>, "keys must be integers");
+    using U = std::make_unsigned_t<Key>;
+    auto u = static_cast<U>(key);
+    if constexpr (std::is_signed_v<Key>) {
+        u ^= U{1} << (std::numeric_limits<U>::digits - 1); // Negatives first.
+    }
+    return u;
+}
+
+template <typename Key, typename T>
+class RadixHeap
+{
+public:
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+
+    bool empty() const { return n == 0; }
+    std::size_t size() const { return n; }
+
+    const value_type& top() const
+    {
+        refill();
+        return buckets[0].back();
+    }
+
+    void push(const value_type& value) { emplace(value.first, value.second); }
+
+    template <typename... Args>
+    void emplace(Key key, Args&&... args)
+    {
+        auto bits = _ordered_bits(key);
+        if (n == 0) {
+            last = 0; // Until the next top, any key is allowed.
+        }
+        else if (bits < last) {
+            throw std::invalid_argument{"RadixHeap: key less than last"};
+        }
+        buckets[bucket(bits)].emplace_back(std::piecewise_construct,
+                                           std::forward_as_tuple(key),
+                                           std::forward_as_tuple(std::forward<Args>(args)...));
+        ++n;
+    }
+
+    void pop()
+    {
+        refill();
+        buckets[0].pop_back();
+        --n;
+    }
+
+private:
+    using Bits = std::make_unsigned_t<Key>;
+    static constexpr int num_bits = std::numeric_limits<Bits>::digits;
+
+    // bucket is 0 when bits == last, else 1 plus the highest differing bit.
+    std::size_t bucket(Bits bits) const
+    {
+        std::uint64_t diff = bits ^ last;
+        return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+    }
+
+    // refill makes the least key the last one and redistributes the bucket
+    // holding it, whose elements all go to lower buckets, when bucket 0 is
+    // empty. Bucket 0 then holds the elements of least key.
+    void refill() const
+    {
+        if (!buckets[0].empty()) {
+            return;
+        }
+        std::size_t i = 1;
+        while (buckets[i].empty()) {
+            ++i;
+        }
+        auto& from = buckets[i];
+        last = _ordered_bits(std::min_element(from.begin(), from.end(),
+            [](const value_type& v1, const value_type& v2) {
+                return v1.first < v2.first;
+            })->first);
+        for (auto& v : from) {
+            buckets[bucket(_ordered_bits(v.first))].push_back(std::move(v));
+        }
+        from.clear();
+    }
+
+    // top is const like std::priority_queue::top, but may refill.
+    mutable std::array<std::vector<value_type>, num_bits + 1> buckets;
+    mutable Bits last = 0;
+    std::size_t n = 0;
+};
+
+template <typename Key, typename T>
+class CalendarQueue
+{
+public:
+    using value_type = std::pair<Key, T>;
+    using size_type = std::size_t;
+
+    CalendarQueue()
+        : days(min_days)
+    { }
+
+    bool empty() const { return n == 0; }
+    std::size_t size() const { return n; }
+
+    const value_type& top() const
+    {
+        locate();
+        return days[today % days.size()].back();
+    }
+
+    void push(const value_type& value) { emplace(value.first, value.second); }
+
+    template <typename... Args>
+    void emplace(Key key, Args&&... args)
+    {
+        auto bits = _ordered_bits(key);
+        if (n == 0) {
+            last = 0; // Until the next top, any key is allowed.
+            today = bits / width;
+        }
+        else if (bits < last) {
+            throw std::invalid_argument{"CalendarQueue: key less than last"};
+        }
+        today = std::min(today, bits / width);
+        insert(value_type(std::piecewise_construct,
+                          std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...)));
+        if (++n > 2 * days.size()) {
+            resize(2 * days.size());
+        }
+    }
+
+    void pop()
+    {
+        locate();
+        days[today % days.size()].pop_back();
+        if (--n < days.size() / 2 && days.size() > min_days) {
+            resize(days.size() / 2);
+        }
+    }
+
+private:
+    using Bits = std::make_unsigned_t<Key>;
+    static constexpr std::size_t min_days = 2;
+
+    // insert files value on its day, which is sorted by decreasing key so that
+    // the least key is popped from the back.
+    void insert(value_type&& value)
+    {
+        auto bits = _ordered_bits(value.first);
+        auto& day = days[(bits / width) % days.size()];
+        auto it = std::upper_bound(day.begin(), day.end(), bits,
+            [](Bits b, const value_type& v) {
+                return b > _ordered_bits(v.first);
+            });
+        day.insert(it, std::move(value));
+    }
+
+    // locate advances today to the day of the least key, searching the
+    // whole calendar when no key falls in the coming year.
+    void locate() const
+    {
+        for (std::size_t i = 0; i != days.size(); ++i, ++today) {
+            auto& day = days[today % days.size()];
+            if (!day.empty() && _ordered_bits(day.back().first) / width == today) {
+                last = _ordered_bits(day.back().first);
+                return;
+            }
+        }
+        auto least = std::numeric_limits<Bits>::max();
+        for (const auto& day : days) {
+            if (!day.empty()) {
+                least = std::min(least, _ordered_bits(day.back().first));
+            }
+        }
+        last = least;
+        today = least / width;
+    }
+
+    // resize refiles all elements in a calendar of num_days days, each as
+    // wide as about three times the mean separation of the keys.
+    void resize(std::size_t num_days)
+    {
+        std::vector<value_type> values;
+        values.reserve(n);
+        auto lo = std::numeric_limits<Bits>::max(), hi = Bits{0};
+        for (auto& day : days) {
+            for (auto& v : day) {
+                lo = std::min(lo, _ordered_bits(v.first));
+                hi = std::max(hi, _ordered_bits(v.first));
+                values.push_back(std::move(v));
+            }
+        }
+        width = values.size() < 2 ? Bits{1} :
+            std::max<Bits>(1, (hi - lo) / (values.size() - 1) * 3);
+        days.assign(num_days, {});
+        for (auto& v : values) {
+            insert(std::move(v));
+        }
+        today = (values.empty() ? last : lo) / width;
+    }
+
+    // top is const like std::priority_queue::top, but may advance today.
+    std::vector<std::vector<value_type>> days;
+    Bits width = 1;             // Keys per day.
+    mutable Bits today = 0;     // Key / width of the current day.
+    mutable Bits last = 0;      // Key of the last top or pop.
+    std::size_t n = 0;
+};
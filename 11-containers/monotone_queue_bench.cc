@@ -0,0 +1,63 @@
+// Benchmark RadixHeap and CalendarQueue against std::priority_queue as timers.
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "monotone_queue.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+using Timer = std::pair<std::uint64_t, int>; // Deadline and id.
+
+using BinaryHeap = std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>>;
+
+// Each iteration runs the hold model of a timer wheel holding state.arg()
+// timers: num_holds times, the earliest timer fires and schedules another
+// after a random delay.
+constexpr int num_holds = 1'000'000;
+
+template <typename Queue, typename Delay>
+void bench_hold(timeit::State& state, Delay delay)
+{
+    std::default_random_engine gen{};
+    std::vector<std::uint64_t> delays(num_holds);
+    for (auto& d : delays) {
+        d = delay(gen);
+    }
+    while (state.keep_running()) {
+        state.pause_timing();
+        Queue queue;
+        for (int i = 0; i != state.arg(); ++i) {
+            queue.push({delay(gen), i});
+        }
+        state.resume_timing();
+        for (int i = 0; i != num_holds; ++i) {
+            auto [now, id] = queue.top();
+            queue.pop();
+            queue.push({now + delays[i], id});
+        }
+        timeit::do_not_optimize(queue.top());
+    }
+    state.set_items_processed(num_holds);
+}
+
+// uniform delays spread timers evenly, exponential ones bunch them up near now.
+auto uniform = [](auto& gen) {
+    return std::uniform_int_distribution<std::uint64_t>{0, 2000}(gen);
+};
+auto exponential = [](auto& gen) {
+    return static_cast<std::uint64_t>(std::exponential_distribution<>{1e-3}(gen));
+};
+
+#define QUEUE_SIZES 1'000, 100'000, 1'000'000
+
+TIMEIT_BENCHMARK_ARGS("[hold:uniform:std::priority_queue]", QUEUE_SIZES) { bench_hold<BinaryHeap>(state, uniform); }
+TIMEIT_BENCHMARK_ARGS("[hold:uniform:RadixHeap]", QUEUE_SIZES) { bench_hold<RadixHeap<std::uint64_t, int>>(state, uniform); }
+TIMEIT_BENCHMARK_ARGS("[hold:uniform:CalendarQueue]", QUEUE_SIZES) { bench_hold<CalendarQueue<std::uint64_t, int>>(state, uniform); }
+TIMEIT_BENCHMARK_ARGS("[hold:exponential:std::priority_queue]", QUEUE_SIZES) { bench_hold<BinaryHeap>(state, exponential); }
+TIMEIT_BENCHMARK_ARGS("[hold:exponential:RadixHeap]", QUEUE_SIZES) { bench_hold<RadixHeap<std::uint64_t, int>>(state, exponential); }
+TIMEIT_BENCHMARK_ARGS("[hold:exponential:CalendarQueue]", QUEUE_SIZES) { bench_hold<CalendarQueue<std::uint64_t, int>>(state, exponential); }
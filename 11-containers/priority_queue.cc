@@ -5,6 +5,8 @@
 #include <utility>
 #include <vector>
 
+#include "indexed_heap.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
@@ -93,3 +95,40 @@ TEST_CASE("[priority_queue:min_heap]")
     min_heap.emplace(1, 0);
     REQUIRE(min_heap.top() == HeapEntry{1, 0});
 }
+
+TEST_CASE("[priority_queue:MinIndexedHeap]")
+{
+    // Heap contains a pair of ints.
+    using HeapEntry = std::pair<int, int>;
+
+    // Use a lambda function to define heap ordering.
+    auto HeapEntryLess  = [](const HeapEntry& h1, const HeapEntry& h2) {
+        return h1.first == h2.first ?
+            h1.second < h2.second :
+            h1.first < h2.first;
+    };
+
+    // Min heap ordered using HeapEntryLess, top is the least entry.
+    MinIndexedHeap<HeapEntry, decltype(HeapEntryLess)> min_heap(HeapEntryLess);
+
+    // Keep the handle of each entry instead of pushing duplicates.
+    std::vector<MinIndexedHeap<HeapEntry, decltype(HeapEntryLess)>::handle> handles;
+    for (int i = 1; i != 4; ++i) {
+        handles.push_back(min_heap.push({i, i}));
+    }
+    REQUIRE(min_heap.top() == HeapEntry{1, 1});
+
+    // Lower the priority of the top entry in place.
+    min_heap.increase_key(handles[0], {4, 1});
+    REQUIRE(min_heap.top() == HeapEntry{2, 2});
+    REQUIRE(std::size(min_heap) == 3);
+
+    // Raise the priority of the last entry in place.
+    min_heap.decrease_key(handles[2], {0, 3});
+    REQUIRE(min_heap.top() == HeapEntry{0, 3});
+
+    // Remove an entry that is not on top.
+    min_heap.erase(handles[1]);
+    min_heap.pop();
+    REQUIRE(min_heap.top() == HeapEntry{4, 1});
+}
@@ -1,58 +1,85 @@
 // Demonstrate std::execution policies for parallel and/or vectorized sorting.
 #include <algorithm>
-#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <execution>
 #include <iostream>
 #include <numeric>
 #include <random>
-#include <ratio>
+#include <string>
+#include <vector>
 
-template <typename ExecutionPolicy>
-double timeit_sort(ExecutionPolicy&& policy)
+#include "radix_sort.h"
+#include "../13-utilities/timeit.h"
+
+// timeit_sort returns the median time in ms for sort to order nelems shuffled elements.
+template <typename Sort>
+double timeit_sort(std::size_t nelems, Sort sort)
 {
     using T = std::uint64_t;
 
-    // Allocate vector of 1e6 elements.
-    std::size_t nelems = 1'000'000;
+    // Allocate vector of nelems elements.
     std::vector<T> nums(nelems);
     std::iota(std::begin(nums), std::end(nums), T(0));
 
     std::default_random_engine gen{};
 
-    // Capture elapsed time based on nrepeat samples.
-    std::size_t nrepeat = 10;
-    std::vector<double> duration;
-    duration.reserve(nrepeat);
+    // Capture elapsed time based on 10 samples of a single sort each.
+    timeit::Options opts;
+    opts.warmup = 0;
+    opts.samples = 10;
+    opts.max_iterations = 1;
+    opts.max_total_ms = 60e3;
 
-    while (nrepeat > 0) {
-        // Shuffle the input vector.
-        std::shuffle(std::begin(nums), std::end(nums), gen);
+    auto result = timeit::run("sort", [&](timeit::State& state) {
+        while (state.keep_running()) {
+            // Shuffle the input vector outside of the timed region.
+            state.pause_timing();
+            std::shuffle(std::begin(nums), std::end(nums), gen);
+            state.resume_timing();
 
-        auto t1 = std::chrono::steady_clock::now();
-        std::sort(policy, std::begin(nums), std::end(nums));
-        auto t2 = std::chrono::steady_clock::now();
-        duration.push_back(std::chrono::duration<double, std::milli>(t2-t1).count());
+            sort(std::begin(nums), std::end(nums));
+        }
+    }, 0, opts);
 
-        --nrepeat;
-    }
+    return result.median_ns / 1e6;
+}
+
+// std_sort adapts std::sort with policy to the call shape used by timeit_sort.
+template <typename ExecutionPolicy>
+auto std_sort(ExecutionPolicy policy)
+{
+    return [policy](auto first, auto last) { std::sort(policy, first, last); };
+}
 
-    // Compute the mean elapsed time, in ms.
-    double sum = std::accumulate(std::begin(duration), std::end(duration), 0.);
-    double mean = sum / duration.size();
-    return mean;
+// radix adapts radix_sort with policy to the call shape used by timeit_sort.
+template <typename ExecutionPolicy>
+auto radix(ExecutionPolicy policy)
+{
+    return [policy](auto first, auto last) { radix_sort(policy, first, last); };
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    // Output:
-    // 952.651 Sequential.
-    // 652.404 Vectorized.
-    // 503.684 Parallel.
-    // 1004.08 Parallel and vectorized.
-    std::cout << timeit_sort(std::execution::seq)       << " Sequential.\n";
-    std::cout << timeit_sort(std::execution::unseq)     << " Vectorized.\n";
-    std::cout << timeit_sort(std::execution::par)       << " Parallel.\n";
-    std::cout << timeit_sort(std::execution::par_unseq) << " Parallel and vectorized.\n";
+    // Sort 1e6 elements, or every power of 10 from 1e6 up to the size given
+    // on the command line e.g. ./parallelsort 1000000000 for 1e6 to 1e9.
+    std::size_t max_nelems = argc > 1 ? std::stoul(argv[1]) : 1'000'000;
+
+    // Output, the median ms of the 10 sorts, on a single core:
+    // nelems=1000000
+    // 494.311 Sequential.
+    // 481.081 Vectorized.
+    // 603.255 Parallel.
+    // 514.465 Parallel and vectorized.
+    // 66.5771 Radix sequential.
+    // 63.045 Radix parallel.
+    for (std::size_t nelems = 1'000'000; nelems <= max_nelems; nelems *= 10) {
+        std::cout << "nelems=" << nelems << '\n';
+        std::cout << timeit_sort(nelems, std_sort(std::execution::seq))       << " Sequential.\n";
+        std::cout << timeit_sort(nelems, std_sort(std::execution::unseq))     << " Vectorized.\n";
+        std::cout << timeit_sort(nelems, std_sort(std::execution::par))       << " Parallel.\n";
+        std::cout << timeit_sort(nelems, std_sort(std::execution::par_unseq)) << " Parallel and vectorized.\n";
+        std::cout << timeit_sort(nelems, radix(std::execution::seq))          << " Radix sequential.\n";
+        std::cout << timeit_sort(nelems, radix(std::execution::par))          << " Radix parallel.\n";
+    }
 }
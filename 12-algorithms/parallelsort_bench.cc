@@ -0,0 +1,61 @@
+// Benchmark std::sort and radix_sort of shuffled std::uint64_t under each execution policy.
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "radix_sort.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// bench_sort sorts a freshly shuffled vector of state.arg() elements.
+template <typename Sort>
+void bench_sort(timeit::State& state, Sort sort)
+{
+    std::vector<std::uint64_t> nums(state.arg());
+    std::iota(std::begin(nums), std::end(nums), 0);
+    std::default_random_engine gen{};
+
+    while (state.keep_running()) {
+        state.pause_timing();
+        std::shuffle(std::begin(nums), std::end(nums), gen);
+        state.resume_timing();
+
+        sort(std::begin(nums), std::end(nums));
+        timeit::clobber_memory();
+    }
+    state.set_items_processed(nums.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[sort:seq]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { std::sort(std::execution::seq, first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[sort:unseq]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { std::sort(std::execution::unseq, first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[sort:par]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { std::sort(std::execution::par, first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[sort:par_unseq]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { std::sort(std::execution::par_unseq, first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[radix_sort:seq]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { radix_sort(std::execution::seq, first, last); });
+}
+
+TIMEIT_BENCHMARK_ARGS("[radix_sort:par]", 10'000, 1'000'000, 10'000'000)
+{
+    bench_sort(state, [](auto first, auto last) { radix_sort(std::execution::par, first, last); });
+}
@@ -0,0 +1,94 @@
+// Implement parallel radix sort with the same call shape as std::sort.
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "radix_sort.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+// random_keys returns n keys uniformly distributed over [0, max].
+template <typename T>
+std::vector<T> random_keys(std::size_t n, T max = std::numeric_limits<T>::max())
+{
+    std::default_random_engine gen{};
+    std::uniform_int_distribution<T> dist{0, max};
+    std::vector<T> keys(n);
+    std::generate(std::begin(keys), std::end(keys), [&] { return dist(gen); });
+    return keys;
+}
+
+TEST_CASE("[radix_sort]")
+{
+    SUBCASE("empty and single element")
+    {
+        std::vector<std::uint64_t> v0;
+        radix_sort(std::begin(v0), std::end(v0));
+        REQUIRE(v0.empty());
+
+        std::vector<std::uint64_t> v1{42};
+        radix_sort(std::begin(v1), std::end(v1));
+        REQUIRE(v1 == std::vector<std::uint64_t>{42});
+    }
+
+    SUBCASE("compare to std::sort")
+    {
+        auto rcv = random_keys<std::uint64_t>(10'000);
+        auto expected = rcv;
+        radix_sort(std::begin(rcv), std::end(rcv));
+        std::sort(std::begin(expected), std::end(expected));
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("small keys skip the passes over high digits")
+    {
+        auto rcv = random_keys<std::uint64_t>(10'000, 1000);
+        auto expected = rcv;
+        radix_sort(std::begin(rcv), std::end(rcv));
+        std::sort(std::begin(expected), std::end(expected));
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("32-bit keys")
+    {
+        auto rcv = random_keys<std::uint32_t>(10'000);
+        auto expected = rcv;
+        radix_sort(std::begin(rcv), std::end(rcv));
+        std::sort(std::begin(expected), std::end(expected));
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("execution policies")
+    {
+        auto input = random_keys<std::uint64_t>(4 * radix_min_parallel);
+        auto expected = input;
+        std::sort(std::begin(expected), std::end(expected));
+
+        auto rcv = input;
+        radix_sort(std::execution::seq, std::begin(rcv), std::end(rcv));
+        REQUIRE(rcv == expected);
+
+        rcv = input;
+        radix_sort(std::execution::par, std::begin(rcv), std::end(rcv));
+        REQUIRE(rcv == expected);
+
+        rcv = input;
+        radix_sort(std::execution::par_unseq, std::begin(rcv), std::end(rcv));
+        REQUIRE(rcv == expected);
+    }
+
+    SUBCASE("per-thread histograms merge into sorted order")
+    {
+        // Force 4 threads regardless of hardware concurrency.
+        auto rcv = random_keys<std::uint64_t>(4 * radix_min_parallel);
+        auto expected = rcv;
+        std::vector<std::uint64_t> buffer(rcv.size());
+        _radix_sort(rcv.data(), buffer.data(), rcv.size(), 4);
+        std::sort(std::begin(expected), std::end(expected));
+        REQUIRE(rcv == expected);
+    }
+}
@@ -0,0 +1,134 @@
+// Parallel least significant digit radix sort of unsigned integer keys.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../06-templates/execution.h"
+
+// Keys are sorted 11 bits at a time so that the histogram of one pass, 2048
+// counters, fits in L1 cache and a 64-bit key takes 6 passes instead of 8.
+constexpr unsigned radix_bits = 11;
+constexpr std::size_t radix_size = std::size_t{1} << radix_bits;
+
+// Ranges smaller than this are sorted by a single thread.
+constexpr std::size_t radix_min_parallel = std::size_t{1} << 16;
+
+using RadixHistogram = std::array<std::size_t, radix_size>;
+
+template <typename T>
+inline std::size_t _radix_digit(T key, unsigned shift)
+{
+    return static_cast<std::size_t>(key >> shift) & (radix_size - 1);
+}
+
+// _radix_sort sorts data[0, n) using buffer[0, n) as scratch with nthreads.
+// Each pass counts digits per thread, converts the counts to per-thread
+// output offsets with a prefix sum, then scatters in parallel, which keeps
+// every pass stable.
+template <typename T>
+void _radix_sort(T* data, T* buffer, std::size_t n, std::size_t nthreads)
+{
+    static_assert(std::is_unsigned_v<T>, "radix_sort requires unsigned keys");
+
+    nthreads = std::max<std::size_t>(1, std::min(nthreads, n / radix_min_parallel));
+    std::vector<RadixHistogram> counts(nthreads);
+
+    T* src = data;
+    T* dst = buffer;
+    for (unsigned shift = 0; shift < std::numeric_limits<T>::digits; shift += radix_bits) {
+        mystd::_for_each_chunk(n, nthreads, [&](std::size_t t, std::size_t b, std::size_t e) {
+            auto& count = counts[t];
+            count.fill(0);
+            for (std::size_t i = b; i != e; ++i) {
+                ++count[_radix_digit(src[i], shift)];
+            }
+        });
+
+        // Skip the pass when every key has the same digit, e.g. the high
+        // digits of small keys.
+        bool skip = false;
+        for (std::size_t d = 0; d != radix_size && !skip; ++d) {
+            std::size_t total = 0;
+            for (const auto& count : counts) {
+                total += count[d];
+            }
+            skip = total == n;
+            if (total != 0) {
+                break;
+            }
+        }
+        if (skip) {
+            continue;
+        }
+
+        // Exclusive prefix sum in digit-major, thread-minor order gives the
+        // first output position of each (thread, digit) pair.
+        std::size_t offset = 0;
+        for (std::size_t d = 0; d != radix_size; ++d) {
+            for (auto& count : counts) {
+                auto c = count[d];
+                count[d] = offset;
+                offset += c;
+            }
+        }
+
+        mystd::_for_each_chunk(n, nthreads, [&](std::size_t t, std::size_t b, std::size_t e) {
+            auto& pos = counts[t];
+            for (std::size_t i = b; i != e; ++i) {
+                auto key = src[i];
+                dst[pos[_radix_digit(key, shift)]++] = key;
+            }
+        });
+
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        std::copy(src, src + n, data);
+    }
+}
+
+// radix_sort sorts the unsigned integer keys in [first, last) in ascending
+// order on the calling thread. RandomIt must refer to contiguous storage.
+template <typename RandomIt>
+void radix_sort(RandomIt first, RandomIt last)
+{
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < 2) {
+        return;
+    }
+    std::vector<T> buffer(n);
+    _radix_sort(&*first, buffer.data(), n, 1);
+}
+
+// radix_sort overload using all hardware threads for the parallel policies.
+template <typename ExecutionPolicy, typename RandomIt,
+          std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>* = nullptr>
+void radix_sort(ExecutionPolicy&&, RandomIt first, RandomIt last)
+{
+    using Policy = std::decay_t<ExecutionPolicy>;
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+
+    std::size_t nthreads = 1;
+    if constexpr (std::is_same_v<Policy, std::execution::parallel_policy> ||
+                  std::is_same_v<Policy, std::execution::parallel_unsequenced_policy>) {
+        nthreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    if (n < 2) {
+        return;
+    }
+    std::vector<T> buffer(n);
+    _radix_sort(&*first, buffer.data(), n, nthreads);
+}
@@ -1,24 +1,16 @@
 // Emit word frequency count based on input read from stdin.
-#include <algorithm>
-#include <iostream>
-#include <iterator>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <string>
-#include <map>
+#include <vector>
+
+#include "wordcount.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// wordcount returns word frequency count from stream.
-std::map<std::string, int>
-wordcount(std::istream& is)
-{
-    std::map<std::string, int> wc;
-    std::for_each(std::istream_iterator<std::string>(is),
-                  std::istream_iterator<std::string>(),
-                  [&wc](const auto& s) { wc[s] += 1; });
-    return wc;
-}
-
 TEST_CASE("[wordcount]")
 {
     std::istringstream is{
@@ -31,3 +23,83 @@ TEST_CASE("[wordcount]")
     REQUIRE(rcv["three"] == 3);
     REQUIRE(rcv["four"] == 4);
 }
+
+TEST_CASE("[WordTable]")
+{
+    WordTable wc{4}; // Small capacity forces the table to grow.
+    std::vector<std::string> words;
+    for (int i = 0; i != 100; ++i) {
+        words.push_back("word" + std::to_string(i));
+    }
+    for (int i = 0; i != 100; ++i) {
+        for (int n = 0; n <= i; ++n) {
+            wc.add(words[i]);
+        }
+    }
+    REQUIRE(wc.size() == 100);
+    for (int i = 0; i != 100; ++i) {
+        REQUIRE(wc.count(words[i]) == i + 1);
+    }
+    REQUIRE(wc.count("missing") == 0);
+    REQUIRE_THROWS_AS(wc.add(words[0], 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(wc.add("missing", -1), std::invalid_argument);
+    REQUIRE(wc.count(words[0]) == 1);
+    REQUIRE(wc.size() == 100);
+
+    SUBCASE("merge")
+    {
+        WordTable other;
+        other.add(words[0], 10);
+        other.add("new");
+        wc.merge(other);
+        REQUIRE(wc.size() == 101);
+        REQUIRE(wc.count(words[0]) == 11);
+        REQUIRE(wc.count("new") == 1);
+    }
+}
+
+TEST_CASE("[wordcount:string_view]")
+{
+    SUBCASE("same result as std::istream")
+    {
+        std::string text{" one two\tthree four\ntwo three four three four four \n"};
+        std::istringstream is{text};
+        REQUIRE(to_map(wordcount(text)) == wordcount(is));
+    }
+
+    SUBCASE("empty and whitespace only")
+    {
+        REQUIRE(wordcount("").size() == 0);
+        REQUIRE(wordcount(" \n\t ").size() == 0);
+    }
+
+    SUBCASE("chunk boundaries do not split words")
+    {
+        // Large enough text to be split across 8 threads.
+        std::string text;
+        for (int i = 0; i != 100'000; ++i) {
+            text += "alpha beta\tgamma\n" + std::to_string(i % 7) + ' ';
+        }
+        std::istringstream is{text};
+        auto expected = wordcount(is);
+        REQUIRE(to_map(wordcount(text, 1)) == expected);
+        REQUIRE(to_map(wordcount(text, 8)) == expected);
+    }
+}
+
+TEST_CASE("[wordcount_file]")
+{
+    std::string filename{"wordcount_test.txt"};
+    std::string text{"one two three four two three four three four four\n"};
+
+    // Setup.
+    {
+        std::ofstream os{filename};
+        os << text;
+    }
+
+    std::istringstream is{text};
+    REQUIRE(wordcount_file(filename) == wordcount(is));
+
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,228 @@
+// Word frequency count of whitespace separated tokens.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "../10-input-and-output/mapped_file.h"
+
+// wordcount returns word frequency count from stream.
+inline std::map<std::string, int>
+wordcount(std::istream& is)
+{
+    std::map<std::string, int> wc;
+    std::for_each(std::istream_iterator<std::string>(is),
+                  std::istream_iterator<std::string>(),
+                  [&wc](const auto& s) { wc[s] += 1; });
+    return wc;
+}
+
+// WordTable is an open addressing hash table from word to count using linear
+// probing. Words are string_view into the counted text, so counting performs
+// no allocation per word and the text must outlive the table.
+class WordTable
+{
+public:
+    // Capacity is rounded up to a power of 2 so probing can mask the hash.
+    explicit WordTable(std::size_t capacity = 1024)
+    {
+        std::size_t n = 16;
+        while (n < capacity) {
+            n *= 2;
+        }
+        slots.resize(n);
+    }
+
+    // add increments the count of word by n, which must be positive since a
+    // count of 0 marks an empty slot, std::invalid_argument otherwise.
+    void add(std::string_view word, int n = 1)
+    {
+        if (n < 1) {
+            throw std::invalid_argument{"WordTable::add: count must be positive"};
+        }
+        add(word, std::hash<std::string_view>()(word), n);
+    }
+
+    // count returns the count of word or 0 when not found.
+    int count(std::string_view word) const
+    {
+        return slots[probe(word, std::hash<std::string_view>()(word))].count;
+    }
+
+    // size returns the number of distinct words.
+    std::size_t size() const
+    {
+        return used;
+    }
+
+    // merge adds the counts of other to this table.
+    void merge(const WordTable& other)
+    {
+        for (const auto& s : other.slots) {
+            if (s.count != 0) {
+                add(s.word, s.hash, s.count);
+            }
+        }
+    }
+
+    // for_each calls func(word, count) for every word in unspecified order.
+    template <typename Func>
+    void for_each(Func func) const
+    {
+        for (const auto& s : slots) {
+            if (s.count != 0) {
+                func(s.word, s.count);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::string_view word;
+        std::size_t hash = 0;
+        int count = 0; // Zero marks an empty slot.
+    };
+
+    // probe returns the slot holding word or the empty slot where it belongs.
+    std::size_t probe(std::string_view word, std::size_t h) const
+    {
+        std::size_t mask = slots.size() - 1;
+        std::size_t i = h & mask;
+        while (slots[i].count != 0 &&
+               (slots[i].hash != h || slots[i].word != word)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void add(std::string_view word, std::size_t h, int n)
+    {
+        auto& s = slots[probe(word, h)];
+        if (s.count == 0) {
+            s.word = word;
+            s.hash = h;
+            s.count = n;
+            // Keep the load factor below 1/2 so probe sequences stay short.
+            if (++used * 2 > slots.size()) {
+                grow();
+            }
+        } else {
+            s.count += n;
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(slots.size() * 2);
+        std::swap(old, slots);
+        std::size_t mask = slots.size() - 1;
+        for (const auto& s : old) {
+            if (s.count != 0) {
+                std::size_t i = s.hash & mask;
+                while (slots[i].count != 0) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = s;
+            }
+        }
+    }
+
+    std::vector<Slot> slots;
+    std::size_t used = 0;
+};
+
+// is_space matches the whitespace that separates std::istream_iterator tokens.
+inline bool is_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// wordcount_chunk counts the words of text into wc.
+inline void wordcount_chunk(std::string_view text, WordTable& wc)
+{
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p != end) {
+        while (p != end && is_space(*p)) {
+            ++p;
+        }
+        const char* word = p;
+        while (p != end && !is_space(*p)) {
+            ++p;
+        }
+        if (p != word) {
+            wc.add({word, static_cast<std::size_t>(p - word)});
+        }
+    }
+}
+
+// wordcount returns the word frequency count of text using nthreads threads.
+// text is split into chunks at whitespace so that no word straddles two
+// chunks, each chunk is counted into a thread-local table, and the tables are
+// merged at the end. The words of the result are views into text.
+inline WordTable
+wordcount(std::string_view text,
+          std::size_t nthreads = std::max(1U, std::thread::hardware_concurrency()))
+{
+    // Chunks smaller than this are not worth the cost of a thread.
+    constexpr std::size_t min_chunk = 1 << 16;
+    nthreads = std::max<std::size_t>(1, std::min(nthreads, text.size() / min_chunk));
+
+    // Advance each chunk boundary past the word it splits.
+    std::vector<std::size_t> bounds(nthreads + 1, text.size());
+    bounds[0] = 0;
+    for (std::size_t t = 1; t < nthreads; ++t) {
+        std::size_t b = std::max(text.size() * t / nthreads, bounds[t - 1]);
+        while (b < text.size() && !is_space(text[b])) {
+            ++b;
+        }
+        bounds[t] = b;
+    }
+
+    std::vector<WordTable> tables(nthreads);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < nthreads; ++t) {
+        workers.emplace_back([&, t] {
+            wordcount_chunk(text.substr(bounds[t], bounds[t + 1] - bounds[t]), tables[t]);
+        });
+    }
+    wordcount_chunk(text.substr(0, bounds[1]), tables[0]);
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    for (std::size_t t = 1; t < nthreads; ++t) {
+        tables[0].merge(tables[t]);
+    }
+    return std::move(tables[0]);
+}
+
+// to_map adapts a WordTable to the result of the std::istream overload.
+inline std::map<std::string, int>
+to_map(const WordTable& wc)
+{
+    std::map<std::string, int> m;
+    wc.for_each([&m](std::string_view word, int count) {
+        m.emplace(word, count);
+    });
+    return m;
+}
+
+// wordcount_file returns the word frequency count of a memory-mapped file.
+inline std::map<std::string, int>
+wordcount_file(const std::string& filename,
+               std::size_t nthreads = std::max(1U, std::thread::hardware_concurrency()))
+{
+    MappedFile file{filename};
+    return to_map(wordcount(file.view(), nthreads));
+}
@@ -0,0 +1,88 @@
+// Benchmark wordcount on a synthetic corpus with a Zipf-like vocabulary.
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "wordcount.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// make_corpus returns nwords space separated words drawn from a vocabulary
+// where the frequency of word i is proportional to 1/(i+1).
+std::string make_corpus(std::size_t nwords, std::size_t vocabulary = 10'000)
+{
+    std::vector<double> weights(vocabulary);
+    for (std::size_t i = 0; i != vocabulary; ++i) {
+        weights[i] = 1. / (i + 1);
+    }
+    std::discrete_distribution<std::size_t> dist(weights.begin(), weights.end());
+    std::default_random_engine gen{};
+
+    std::string corpus;
+    for (std::size_t i = 0; i != nwords; ++i) {
+        corpus += "word" + std::to_string(dist(gen)) + ' ';
+    }
+    return corpus;
+}
+
+TIMEIT_BENCHMARK_ARGS("[wordcount]", 1'000, 100'000, 1'000'000)
+{
+    auto corpus = make_corpus(state.arg());
+    while (state.keep_running()) {
+        std::istringstream is{corpus};
+        timeit::do_not_optimize(wordcount(is));
+    }
+    state.set_items_processed(state.arg());
+    state.set_bytes_processed(corpus.size());
+}
+
+TIMEIT_BENCHMARK_ARGS("[wordcount:string_view]", 1'000, 100'000, 1'000'000)
+{
+    auto corpus = make_corpus(state.arg());
+    while (state.keep_running()) {
+        timeit::do_not_optimize(wordcount(corpus));
+    }
+    state.set_items_processed(state.arg());
+    state.set_bytes_processed(corpus.size());
+}
+
+// CorpusFile is a temporary file of corpus, written once and removed when the
+// benchmark returns.
+struct CorpusFile
+{
+    explicit CorpusFile(const std::string& corpus)
+        : filename{(std::filesystem::temp_directory_path() /
+                    ("wordcount_bench." + std::to_string(::getpid()) + ".txt")).string()}
+    {
+        std::ofstream os{filename};
+        os << corpus;
+    }
+
+    ~CorpusFile()
+    {
+        std::filesystem::remove(filename);
+    }
+
+    CorpusFile(const CorpusFile&) = delete;
+    CorpusFile& operator=(const CorpusFile&) = delete;
+
+    std::string filename;
+};
+
+TIMEIT_BENCHMARK_ARGS("[wordcount_file]", 1'000, 100'000, 1'000'000)
+{
+    auto corpus = make_corpus(state.arg());
+    CorpusFile file{corpus};
+    while (state.keep_running()) {
+        timeit::do_not_optimize(wordcount_file(file.filename));
+    }
+    state.set_items_processed(state.arg());
+    state.set_bytes_processed(corpus.size());
+}
@@ -1,15 +1,194 @@
 // Demonstrate use of std::chrono for microbenchmarking.
 #include <chrono>
-#include <iostream>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "timeit.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
 
 using namespace std::chrono_literals;
 
-int main()
+TEST_CASE("[steady_clock]")
 {
     auto t1 = std::chrono::steady_clock::now();
-    std::this_thread::sleep_for(5s); // Duration literal.
+    std::this_thread::sleep_for(50ms); // Duration literal.
     auto t2 = std::chrono::steady_clock::now();
     auto elapsed_ms = std::chrono::duration<double, std::milli>(t2-t1).count();
-    std::cout << "elapsed: " << elapsed_ms << "ms\n";
+    REQUIRE(elapsed_ms >= 50.);
+}
+
+TEST_CASE("[timeit:percentile]")
+{
+    std::vector<double> sorted{1., 2., 3., 4., 5.};
+    REQUIRE(timeit::percentile(sorted, 0.) == 1.);
+    REQUIRE(timeit::percentile(sorted, 50.) == 3.);
+    REQUIRE(timeit::percentile(sorted, 100.) == 5.);
+    // Interpolate between closest ranks.
+    REQUIRE(timeit::percentile(sorted, 99.) == doctest::Approx(4.96));
+    REQUIRE(timeit::percentile({}, 50.) == 0.);
+}
+
+TEST_CASE("[timeit:summarize]")
+{
+    timeit::Result result;
+    timeit::summarize({4., 2., 8., 6.}, result); // Unsorted samples.
+    REQUIRE(result.samples == 4);
+    REQUIRE(result.min_ns == 2.);
+    REQUIRE(result.max_ns == 8.);
+    REQUIRE(result.median_ns == 5.);
+    REQUIRE(result.mean_ns == 5.);
+    REQUIRE(result.stddev_ns == doctest::Approx(2.5819889));
+}
+
+TEST_CASE("[timeit:run]")
+{
+    timeit::Options opts;
+    opts.samples = 5;
+    opts.min_sample_ms = 1.;
+
+    SUBCASE("nullary function")
+    {
+        std::uint64_t x = 0;
+        auto rcv = timeit::run("incr", [&x] {
+            timeit::do_not_optimize(++x);
+        }, 0, opts);
+        REQUIRE(rcv.name == "incr");
+        REQUIRE(rcv.samples == opts.samples);
+        REQUIRE(rcv.iterations > 1); // Calibrated up from 1 iteration.
+        REQUIRE(rcv.min_ns <= rcv.median_ns);
+        REQUIRE(rcv.median_ns <= rcv.p99_ns);
+        REQUIRE(rcv.p99_ns <= rcv.max_ns);
+    }
+
+    SUBCASE("State with arg, counters and throughput")
+    {
+        auto rcv = timeit::run("sum", [](timeit::State& state) {
+            std::vector<std::int64_t> v(state.arg(), 1);
+            while (state.keep_running()) {
+                std::int64_t sum = 0;
+                for (auto x : v) {
+                    sum += x;
+                }
+                timeit::do_not_optimize(sum);
+            }
+            state.set_items_processed(v.size());
+            state.counters["size"] = v.size();
+        }, 1000, opts);
+        REQUIRE(rcv.items_per_second > 0.);
+        REQUIRE(rcv.counters["size"] == 1000.);
+    }
+
+    SUBCASE("pause_timing excludes setup")
+    {
+        opts.samples = 2;
+        opts.max_iterations = 4;
+        auto rcv = timeit::run("paused", [](timeit::State& state) {
+            while (state.keep_running()) {
+                state.pause_timing();
+                std::this_thread::sleep_for(1ms);
+                state.resume_timing();
+            }
+        }, 0, opts);
+        REQUIRE(rcv.max_ns < 1e6);
+    }
+
+    SUBCASE("setup runs once for all samples")
+    {
+        int calls = 0;
+        std::size_t iterations = 0;
+        auto rcv = timeit::run("setup", [&](timeit::State& state) {
+            ++calls;
+            while (state.keep_running()) {
+                ++iterations;
+            }
+        }, 0, opts);
+        REQUIRE(calls == 1);
+        REQUIRE(rcv.samples == opts.samples);
+        // Calibration and warmup iterations come before the samples.
+        REQUIRE(iterations > rcv.iterations * rcv.samples);
+    }
+
+    SUBCASE("benchmark must call keep_running")
+    {
+        REQUIRE_THROWS_AS(timeit::run("idle", [](timeit::State&) {}, 0, opts),
+                          std::logic_error);
+    }
+}
+
+TEST_CASE("[timeit:Workers]")
+{
+    constexpr std::size_t num_threads = 4;
+    std::vector<int> calls(num_threads);
+    {
+        timeit::Workers workers{num_threads, [&calls](std::size_t t) { ++calls[t]; }};
+        for (int i = 0; i != 3; ++i) {
+            workers.run();
+            // run returns once every thread made its call.
+            REQUIRE(calls == std::vector<int>(num_threads, i + 1));
+        }
+    }
+    REQUIRE(calls == std::vector<int>(num_threads, 3));
+}
+
+TEST_CASE("[timeit:run_registered]")
+{
+    timeit::registry().clear();
+    timeit::register_benchmark("[noop]", [](timeit::State& state) {
+        while (state.keep_running()) {
+            timeit::clobber_memory();
+        }
+    }, {1, 2});
+
+    SUBCASE("json")
+    {
+        const char* argv[] = {"./timeit", "--format=json", "--filter=[noop]",
+                              "--samples=2", "--min-sample-ms=0.1"};
+        std::ostringstream os;
+        REQUIRE(timeit::run_registered(5, argv, os) == 0);
+
+        // One json object per line per registered arg.
+        std::istringstream is{os.str()};
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(is, line); ) {
+            lines.push_back(line);
+        }
+        REQUIRE(lines.size() == 2);
+        REQUIRE(lines[0].find("{\"suite\":\"timeit\",\"name\":\"[noop]/1\"") == 0);
+        REQUIRE(lines[1].find("\"name\":\"[noop]/2\"") != std::string::npos);
+    }
+
+    SUBCASE("csv")
+    {
+        const char* argv[] = {"./timeit", "--format=csv", "--filter=[noop]/2",
+                              "--samples=2", "--min-sample-ms=0.1"};
+        std::ostringstream os;
+        REQUIRE(timeit::run_registered(5, argv, os) == 0);
+        REQUIRE(os.str().find("suite,name,iterations") == 0);
+        REQUIRE(os.str().find("\ntimeit,[noop]/2,") != std::string::npos);
+    }
+
+    SUBCASE("json escapes control characters and writes null for NaN")
+    {
+        timeit::Result r;
+        r.name = "a\"b\\c\n\t";
+        r.counters["nan"] = std::numeric_limits<double>::quiet_NaN();
+        r.counters["inf"] = std::numeric_limits<double>::infinity();
+        std::ostringstream os;
+        timeit::write_result(os, "suite", r, timeit::Format::json);
+        REQUIRE(os.str().find(R"("name":"a\"b\\c\u000a\u0009")") != std::string::npos);
+        REQUIRE(os.str().find(R"("counters":{"inf":null,"nan":null})") != std::string::npos);
+    }
+
+    SUBCASE("invalid argument")
+    {
+        const char* argv[] = {"./timeit", "--format=xml"};
+        std::ostringstream os;
+        REQUIRE(timeit::run_registered(2, argv, os) == 2);
+    }
 }
@@ -0,0 +1,609 @@
+// Header-only microbenchmark harness built on std::chrono::steady_clock.
+//
+// Benchmarks are registered with TIMEIT_BENCHMARK and run by the main
+// function emitted when TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN is defined, in the
+// same way that doctest emits main for the tests:
+//
+//     #define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+//     #include "../13-utilities/timeit.h"
+//
+//     TIMEIT_BENCHMARK("[wordcount]")
+//     {
+//         std::string text = read_text();
+//         while (state.keep_running()) {
+//             timeit::do_not_optimize(wordcount(text));
+//         }
+//     }
+//
+// The body is invoked once per benchmark, and all of its samples are taken
+// within the keep_running loop, so the setup before the loop runs once.
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace timeit {
+
+using clock = std::chrono::steady_clock;
+
+// do_not_optimize forces the compiler to materialize value in a register or
+// memory so that the computation producing it cannot be discarded.
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// GCC may pick the register alternative of "+m,r" for a value that lives in
+// memory and lose the stores to it, so it is given memory only.
+template <typename T>
+inline void do_not_optimize(T& value)
+{
+#if defined(__clang__)
+    asm volatile("" : "+r,m"(value) : : "memory");
+#else
+    asm volatile("" : "+m"(value) : : "memory");
+#endif
+}
+
+// clobber_memory forces all pending writes to memory to be committed.
+inline void clobber_memory()
+{
+    asm volatile("" : : : "memory");
+}
+
+// Options controls warmup, calibration and sampling for each benchmark.
+struct Options
+{
+    std::size_t warmup = 1;        // Samples run and discarded before measuring.
+    std::size_t samples = 15;      // Samples recorded per benchmark.
+    double min_sample_ms = 5.;     // Calibrate iterations so a sample lasts this long.
+    double max_total_ms = 2000.;   // Stop sampling once this budget is spent.
+    std::size_t max_iterations = 1'000'000'000;
+};
+
+// State is passed to each benchmark, which is invoked once per registered
+// arg and loops on keep_running. The loop is split into samples of a number
+// of iterations, calibrated and then warmed up before the samples are
+// recorded, so the setup before the loop and the teardown after it run once.
+class State
+{
+public:
+    explicit State(std::int64_t arg, const Options& opts = {})
+        : arg_{arg}, opts_{opts}
+    {}
+
+    // keep_running returns true until all samples are taken, starting the
+    // clock at the start of each sample and stopping it at the end.
+    bool keep_running()
+    {
+        if (remaining_ > 0) {
+            --remaining_;
+            return true;
+        }
+        return next_sample();
+    }
+
+    // pause_timing excludes work such as per-iteration setup from the sample.
+    void pause_timing()
+    {
+        if (running_) {
+            elapsed_ += clock::now() - start_;
+            running_ = false;
+        }
+    }
+
+    void resume_timing()
+    {
+        if (!running_) {
+            running_ = true;
+            start_ = clock::now();
+        }
+    }
+
+    // arg is the parameter the benchmark was registered with, e.g. input size.
+    std::int64_t arg() const { return arg_; }
+
+    // iterations is the number of iterations per sample.
+    std::size_t iterations() const { return iterations_; }
+
+    bool started() const { return started_; }
+
+    // samples are the recorded times per iteration in ns.
+    const std::vector<double>& samples() const { return samples_; }
+
+    // set_items_processed records the items handled by a single iteration.
+    void set_items_processed(double n) { items_ = n; }
+
+    // set_bytes_processed records the bytes handled by a single iteration.
+    void set_bytes_processed(double n) { bytes_ = n; }
+
+    double items_processed() const { return items_; }
+    double bytes_processed() const { return bytes_; }
+
+    // counters are reported verbatim with the result e.g. error or fairness.
+    std::map<std::string, double> counters;
+
+private:
+    enum class Phase { calibrate, warmup, sample, done };
+
+    // next_sample ends the current sample, if any, and starts the next one,
+    // returning false once all samples are taken.
+    bool next_sample()
+    {
+        if (started_) {
+            pause_timing();
+            end_sample(std::chrono::duration<double, std::nano>(elapsed_).count());
+        }
+        started_ = true;
+        if (phase_ == Phase::done) {
+            return false;
+        }
+        elapsed_ = {};
+        remaining_ = iterations_ - 1;
+        resume_timing();
+        return true;
+    }
+
+    void end_sample(double ns)
+    {
+        switch (phase_) {
+        case Phase::calibrate:
+            // Grow the iteration count geometrically until one sample is long
+            // enough that clock resolution and loop overhead are negligible.
+            if (ns >= opts_.min_sample_ms * 1e6 || iterations_ >= opts_.max_iterations) {
+                phase_ = opts_.warmup > 0 ? Phase::warmup : Phase::sample;
+            } else {
+                double mult = ns > 0. ? 1.4 * opts_.min_sample_ms * 1e6 / ns : 10.;
+                mult = std::clamp(mult, 2., 10.);
+                iterations_ = std::min(static_cast<std::size_t>(iterations_ * mult),
+                                       opts_.max_iterations);
+            }
+            break;
+        case Phase::warmup:
+            if (++warmups_ == opts_.warmup) {
+                phase_ = Phase::sample;
+            }
+            break;
+        case Phase::sample:
+            samples_.push_back(ns / iterations_);
+            total_ns_ += ns;
+            break;
+        case Phase::done:
+            break;
+        }
+        if (phase_ == Phase::sample &&
+            (samples_.size() >= opts_.samples ||
+             (!samples_.empty() && total_ns_ >= opts_.max_total_ms * 1e6))) {
+            phase_ = Phase::done;
+        }
+    }
+
+    std::int64_t arg_;
+    Options opts_;
+    Phase phase_ = Phase::calibrate;
+    std::size_t iterations_ = 1;
+    std::size_t remaining_ = 0;
+    std::size_t warmups_ = 0;
+    std::vector<double> samples_;
+    double total_ns_ = 0.;
+    bool started_ = false;
+    bool running_ = false;
+    clock::time_point start_{};
+    clock::duration elapsed_{};
+    double items_ = 0.;
+    double bytes_ = 0.;
+};
+
+// Result summarizes the per-iteration time in ns over all samples.
+struct Result
+{
+    std::string name;
+    std::size_t iterations = 0; // Iterations per sample.
+    std::size_t samples = 0;
+    double min_ns = 0.;
+    double median_ns = 0.;
+    double mean_ns = 0.;
+    double p99_ns = 0.;
+    double max_ns = 0.;
+    double stddev_ns = 0.;
+    double items_per_second = 0.;
+    double bytes_per_second = 0.;
+    std::map<std::string, double> counters;
+};
+
+// percentile returns the p-th percentile, 0 <= p <= 100, of sorted values
+// using linear interpolation between closest ranks.
+inline double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0.;
+    }
+    double rank = p / 100. * (sorted.size() - 1);
+    auto lo = static_cast<std::size_t>(std::floor(rank));
+    auto hi = static_cast<std::size_t>(std::ceil(rank));
+    return sorted[lo] + (rank - lo) * (sorted[hi] - sorted[lo]);
+}
+
+// summarize fills the order and moment statistics of result from samples.
+inline void summarize(std::vector<double> samples, Result& result)
+{
+    result.samples = samples.size();
+    if (samples.empty()) {
+        return;
+    }
+    std::sort(std::begin(samples), std::end(samples));
+    double n = samples.size();
+    double mean = std::accumulate(std::begin(samples), std::end(samples), 0.) / n;
+    double ss = 0.;
+    for (auto x : samples) {
+        ss += (x - mean) * (x - mean);
+    }
+    result.min_ns = samples.front();
+    result.max_ns = samples.back();
+    result.median_ns = percentile(samples, 50.);
+    result.p99_ns = percentile(samples, 99.);
+    result.mean_ns = mean;
+    result.stddev_ns = samples.size() > 1 ? std::sqrt(ss / (n - 1)) : 0.;
+}
+
+// run calibrates, warms up and samples func, returning the summary statistics.
+// func is either invocable with State& and loops on keep_running itself, or
+// is a nullary function that is invoked once per iteration.
+template <typename Func>
+Result run(const std::string& name, Func&& func, std::int64_t arg = 0,
+           const Options& opts = {})
+{
+    State state{arg, opts};
+    if constexpr (std::is_invocable_v<Func&, State&>) {
+        func(state);
+        if (!state.started()) {
+            throw std::logic_error{"benchmark did not call keep_running"};
+        }
+    } else {
+        while (state.keep_running()) {
+            func();
+        }
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = state.iterations();
+    result.counters = std::move(state.counters);
+    summarize(state.samples(), result);
+    if (result.mean_ns > 0.) {
+        result.items_per_second = state.items_processed() / result.mean_ns * 1e9;
+        result.bytes_per_second = state.bytes_processed() / result.mean_ns * 1e9;
+    }
+    return result;
+}
+
+// Workers runs func(t) on threads t in [0, num_threads), started once for
+// all the samples of a benchmark of threaded code. run releases the threads
+// together and returns once every call of func returned, so that a sample
+// times the calls of func and not the creation and join of the threads.
+// func must not throw.
+class Workers
+{
+public:
+    Workers(std::size_t num_threads, std::function<void(std::size_t)> func)
+        : func{std::move(func)}
+    {
+        try {
+            for (std::size_t t = 0; t != num_threads; ++t) {
+                threads.emplace_back([this, t] { loop(t); });
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~Workers() { stop(); }
+
+    Workers(const Workers&) = delete;
+    Workers& operator=(const Workers&) = delete;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock{m};
+        pending = threads.size();
+        ++generation;
+        start.notify_all();
+        done.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    void loop(std::size_t t)
+    {
+        std::size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock{m};
+                start.wait(lock, [this, seen] { return generation != seen || stopped; });
+                if (stopped) {
+                    return;
+                }
+                seen = generation;
+            }
+            func(t);
+            std::lock_guard<std::mutex> lock{m};
+            if (--pending == 0) {
+                done.notify_one();
+            }
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m};
+            stopped = true;
+        }
+        start.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    std::function<void(std::size_t)> func;
+    std::mutex m;
+    std::condition_variable start; // generation advanced or stopped.
+    std::condition_variable done;  // pending reached 0.
+    std::size_t generation = 0;
+    std::size_t pending = 0;
+    bool stopped = false;
+    std::vector<std::thread> threads;
+};
+
+// Benchmark is a registered benchmark function and its parameter.
+struct Benchmark
+{
+    std::string name;
+    std::function<void(State&)> func;
+    std::int64_t arg = 0;
+};
+
+inline std::vector<Benchmark>& registry()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+// register_benchmark adds one benchmark per arg, named name/arg, or a single
+// benchmark named name when args is empty.
+inline bool register_benchmark(const std::string& name,
+                               std::function<void(State&)> func,
+                               const std::vector<std::int64_t>& args = {})
+{
+    if (args.empty()) {
+        registry().push_back({name, func, 0});
+    }
+    for (auto arg : args) {
+        registry().push_back({name + "/" + std::to_string(arg), func, arg});
+    }
+    return true;
+}
+
+enum class Format { console, csv, json };
+
+// write_header writes the column names for the csv and console formats.
+inline void write_header(std::ostream& os, Format format)
+{
+    if (format == Format::csv) {
+        os << "suite,name,iterations,samples,min_ns,median_ns,mean_ns,p99_ns,"
+              "max_ns,stddev_ns,items_per_second,bytes_per_second,counters\n";
+    } else if (format == Format::console) {
+        os << std::left << std::setw(40) << "name" << std::right
+           << std::setw(12) << "iterations"
+           << std::setw(14) << "min(ns)"
+           << std::setw(14) << "median(ns)"
+           << std::setw(14) << "p99(ns)"
+           << std::setw(14) << "stddev(ns)" << '\n';
+    }
+}
+
+// json_string returns s as a json string literal. It is not named quoted,
+// which would lose to std::quoted found by argument dependent lookup.
+inline std::string json_string(std::string_view s)
+{
+    std::string q{'"'};
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            q += '\\';
+            q += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            // Control characters must be escaped, as \u00XX.
+            const char* hex = "0123456789abcdef";
+            q += "\\u00";
+            q += hex[c >> 4];
+            q += hex[c & 0xf];
+        } else {
+            q += c;
+        }
+    }
+    q += '"';
+    return q;
+}
+
+// json_number returns x as a json number, or null when x is not finite
+// since json has no NaN nor infinity.
+inline std::string json_number(double x)
+{
+    if (!std::isfinite(x)) {
+        return "null";
+    }
+    std::ostringstream os;
+    os << x;
+    return os.str();
+}
+
+// write_result writes result as one line of output, a json object per line
+// for the json format so that the output of many suites can be concatenated.
+inline void write_result(std::ostream& os, std::string_view suite,
+                         const Result& r, Format format)
+{
+    if (format == Format::console) {
+        std::ostringstream line;
+        line << std::left << std::setw(40) << r.name << std::right
+             << std::fixed << std::setprecision(1)
+             << std::setw(12) << r.iterations
+             << std::setw(14) << r.min_ns
+             << std::setw(14) << r.median_ns
+             << std::setw(14) << r.p99_ns
+             << std::setw(14) << r.stddev_ns;
+        line << std::defaultfloat << std::setprecision(4);
+        if (r.items_per_second > 0.) {
+            line << "  items/s=" << r.items_per_second;
+        }
+        if (r.bytes_per_second > 0.) {
+            line << "  bytes/s=" << r.bytes_per_second;
+        }
+        for (const auto& [key, value] : r.counters) {
+            line << "  " << key << '=' << value;
+        }
+        os << line.str() << '\n';
+    } else if (format == Format::csv) {
+        os << suite << ',' << r.name << ',' << r.iterations << ','
+           << r.samples << ',' << r.min_ns << ',' << r.median_ns << ','
+           << r.mean_ns << ',' << r.p99_ns << ',' << r.max_ns << ','
+           << r.stddev_ns << ',' << r.items_per_second << ','
+           << r.bytes_per_second << ',';
+        const char* sep = "";
+        for (const auto& [key, value] : r.counters) {
+            os << sep << key << '=' << value;
+            sep = ";";
+        }
+        os << '\n';
+    } else {
+        os << "{\"suite\":" << json_string(suite)
+           << ",\"name\":" << json_string(r.name)
+           << ",\"iterations\":" << r.iterations
+           << ",\"samples\":" << r.samples
+           << ",\"min_ns\":" << json_number(r.min_ns)
+           << ",\"median_ns\":" << json_number(r.median_ns)
+           << ",\"mean_ns\":" << json_number(r.mean_ns)
+           << ",\"p99_ns\":" << json_number(r.p99_ns)
+           << ",\"max_ns\":" << json_number(r.max_ns)
+           << ",\"stddev_ns\":" << json_number(r.stddev_ns)
+           << ",\"items_per_second\":" << json_number(r.items_per_second)
+           << ",\"bytes_per_second\":" << json_number(r.bytes_per_second)
+           << ",\"counters\":{";
+        const char* sep = "";
+        for (const auto& [key, value] : r.counters) {
+            os << sep << json_string(key) << ':' << json_number(value);
+            sep = ",";
+        }
+        os << "}}\n";
+    }
+}
+
+// run_registered runs the registered benchmarks selected by the command line:
+//   --format=console|csv|json  Output format, default console.
+//   --suite=name               Suite reported with results, default argv[0].
+//   --filter=substring         Run only benchmarks whose name contains substring.
+//   --samples=n                Samples recorded per benchmark.
+//   --min-sample-ms=ms         Minimum duration of a sample.
+//   --max-total-ms=ms          Sampling budget per benchmark.
+inline int run_registered(int argc, const char* const* argv,
+                          std::ostream& os = std::cout)
+{
+    Options opts;
+    Format format = Format::console;
+    std::string filter;
+
+    std::string suite = argc > 0 ? argv[0] : "";
+    suite = suite.substr(suite.find_last_of('/') + 1);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view a{argv[i]};
+        auto value = [&a](std::string_view flag) {
+            return std::string{a.substr(flag.size())};
+        };
+        try {
+            if (a.rfind("--format=", 0) == 0) {
+                auto f = value("--format=");
+                if (f == "csv") {
+                    format = Format::csv;
+                } else if (f == "json") {
+                    format = Format::json;
+                } else if (f == "console") {
+                    format = Format::console;
+                } else {
+                    throw std::invalid_argument{f};
+                }
+            } else if (a.rfind("--suite=", 0) == 0) {
+                suite = value("--suite=");
+            } else if (a.rfind("--filter=", 0) == 0) {
+                filter = value("--filter=");
+            } else if (a.rfind("--samples=", 0) == 0) {
+                opts.samples = std::stoul(value("--samples="));
+            } else if (a.rfind("--min-sample-ms=", 0) == 0) {
+                opts.min_sample_ms = std::stod(value("--min-sample-ms="));
+            } else if (a.rfind("--max-total-ms=", 0) == 0) {
+                opts.max_total_ms = std::stod(value("--max-total-ms="));
+            } else {
+                throw std::invalid_argument{std::string{a}};
+            }
+        } catch (const std::exception&) {
+            std::cerr << suite << ": invalid argument: " << a << '\n';
+            return 2;
+        }
+    }
+
+    write_header(os, format);
+    for (const auto& b : registry()) {
+        if (b.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        write_result(os, suite, run(b.name, b.func, b.arg, opts), format);
+        os.flush();
+    }
+    return 0;
+}
+
+}
+
+#define TIMEIT_CAT_(a, b) a##b
+#define TIMEIT_CAT(a, b) TIMEIT_CAT_(a, b)
+
+#define TIMEIT_BENCHMARK_IMPL_(func, name, ...)                             \
+    static void func(timeit::State& state);                               \
+    [[maybe_unused]] static const bool TIMEIT_CAT(func, _registered) =    \
+        timeit::register_benchmark(name, func, __VA_ARGS__);              \
+    static void func([[maybe_unused]] timeit::State& state)
+
+// TIMEIT_BENCHMARK defines a benchmark function body with parameter `state`.
+#define TIMEIT_BENCHMARK(name) \
+    TIMEIT_BENCHMARK_IMPL_(TIMEIT_CAT(timeit_benchmark_, __LINE__), name, {})
+
+// TIMEIT_BENCHMARK_ARGS registers the benchmark once per argument in the
+// list, available in the body as state.arg().
+#define TIMEIT_BENCHMARK_ARGS(name, ...)                                  \
+    TIMEIT_BENCHMARK_IMPL_(TIMEIT_CAT(timeit_benchmark_, __LINE__), name, \
+                           {__VA_ARGS__})
+
+#ifdef TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+int main(int argc, char** argv)
+{
+    return timeit::run_registered(argc, argv);
+}
+#endif
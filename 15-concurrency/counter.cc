@@ -1,37 +1,13 @@
 // Demonstrate use of mutex for sharing counter across threads.
-#include <mutex>
+#include <functional>
 #include <thread>
 #include <vector>
 
+#include "counter.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Counter is a thread-safe counter.
-class Counter
-{
-public:
-    void safe_incr()
-    {
-        std::scoped_lock<std::mutex> guard(m);
-        ++count;
-    }
-
-    void unsafe_incr()
-    {
-        ++count;
-    }
-
-    int value() const
-    {
-        std::scoped_lock<std::mutex> guard(m);
-        return count;
-    }
-
-private:
-    mutable std::mutex m;
-    int count = 0;
-};
-
 TEST_CASE("[counter]")
 {
     // thread_func increments a shared memory counter.
@@ -96,3 +72,80 @@ TEST_CASE("[counter]")
         REQUIRE(counter.value() != expected_count);
     }
 }
+
+// count_safe returns the count after num_threads threads each call
+// safe_incr num_repeat times on counter.
+template <typename C>
+int count_safe(C& counter, int num_threads, int num_repeat)
+{
+    std::vector<std::thread> workers;
+    for (int i = 0; i != num_threads; ++i) {
+        workers.emplace_back([&counter, num_repeat] {
+            for (int n = 0; n != num_repeat; ++n) {
+                counter.safe_incr();
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return counter.value();
+}
+
+TEST_CASE("[counter variants]")
+{
+    constexpr int num_threads = 10;
+    constexpr int num_repeat = 1'000'000;
+    constexpr int expected_count = num_threads*num_repeat;
+
+    SUBCASE("AtomicCounter")
+    {
+        AtomicCounter counter;
+        REQUIRE(count_safe(counter, num_threads, num_repeat) == expected_count);
+    }
+
+    SUBCASE("ShardedCounter")
+    {
+        ShardedCounter counter;
+        REQUIRE(count_safe(counter, num_threads, num_repeat) == expected_count);
+
+        // Fewer shards than threads still count correctly.
+        ShardedCounter one{1};
+        REQUIRE(count_safe(one, num_threads, num_repeat) == expected_count);
+    }
+
+    SUBCASE("BatchedCounter")
+    {
+        // Each thread batches its own increments to the shared counter.
+        AtomicCounter shared;
+        std::vector<std::thread> workers;
+        for (int i = 0; i != num_threads; ++i) {
+            workers.emplace_back([&shared] {
+                BatchedCounter<AtomicCounter> local{shared, 1000};
+                for (int n = 0; n != num_repeat; ++n) {
+                    local.safe_incr();
+                }
+            });
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+        REQUIRE(shared.value() == expected_count);
+    }
+
+    SUBCASE("BatchedCounter flush")
+    {
+        Counter shared;
+        {
+            BatchedCounter<Counter> local{shared, 4};
+            for (int n = 0; n != 6; ++n) {
+                local.safe_incr();
+            }
+            // One batch of 4 was added, 2 increments are pending.
+            REQUIRE(shared.value() == 4);
+            REQUIRE(local.value() == 6);
+        }
+        // Pending increments are added on destruction.
+        REQUIRE(shared.value() == 6);
+    }
+}
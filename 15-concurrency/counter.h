@@ -0,0 +1,185 @@
+// Counter shared by many threads.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counter is a thread-safe counter.
+class Counter
+{
+public:
+    void safe_incr()
+    {
+        std::scoped_lock<std::mutex> guard(m);
+        ++count;
+    }
+
+    void unsafe_incr()
+    {
+        ++count;
+    }
+
+    void add(int n)
+    {
+        std::scoped_lock<std::mutex> guard(m);
+        count += n;
+    }
+
+    int value() const
+    {
+        std::scoped_lock<std::mutex> guard(m);
+        return count;
+    }
+
+private:
+    mutable std::mutex m;
+    int count = 0;
+};
+
+// AtomicCounter is a thread-safe counter without a lock. The increments only
+// need to be atomic, not ordered with other memory, so they are relaxed.
+class AtomicCounter
+{
+public:
+    void safe_incr()
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // unsafe_incr is a separate load and store, so increments can be lost.
+    void unsafe_incr()
+    {
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void add(int n)
+    {
+        count.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    int value() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<int> count{0};
+};
+
+// Size of a cache line, used to keep shards from false sharing.
+constexpr std::size_t cache_line_size = 64;
+
+// _thread_index returns a small integer unique to the calling thread.
+inline std::size_t _thread_index()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+// ShardedCounter spreads the count over one shard per hardware thread, each
+// on its own cache line, so threads incrementing concurrently do not contend
+// for the same line. value() sums the shards, which is slower than an
+// increment and is meant for counters that are written more than read.
+class ShardedCounter
+{
+public:
+    explicit ShardedCounter(std::size_t nshards = std::max(1U, std::thread::hardware_concurrency()))
+        : shards(nshards)
+    {}
+
+    void safe_incr()
+    {
+        shard().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void unsafe_incr()
+    {
+        auto& s = shard();
+        s.store(s.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void add(int n)
+    {
+        shard().fetch_add(n, std::memory_order_relaxed);
+    }
+
+    int value() const
+    {
+        int sum = 0;
+        for (const auto& s : shards) {
+            sum += s.count.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+private:
+    struct alignas(cache_line_size) Shard
+    {
+        std::atomic<int> count{0};
+    };
+
+    std::atomic<int>& shard()
+    {
+        return shards[_thread_index() % shards.size()].count;
+    }
+
+    std::vector<Shard> shards;
+};
+
+// BatchedCounter accumulates increments of one thread locally and adds them
+// to the shared counter once per batch and on destruction, so each thread
+// owns its own BatchedCounter around a shared counter C. value() is the shared
+// count, which lags by the increments still pending in other threads.
+template <typename C>
+class BatchedCounter
+{
+public:
+    explicit BatchedCounter(C& shared, int batch_size = 1024)
+        : shared{shared}, batch_size{batch_size}
+    {}
+
+    BatchedCounter(const BatchedCounter&) = delete;
+    BatchedCounter& operator=(const BatchedCounter&) = delete;
+
+    ~BatchedCounter()
+    {
+        flush();
+    }
+
+    void safe_incr()
+    {
+        if (++pending == batch_size) {
+            flush();
+        }
+    }
+
+    void unsafe_incr()
+    {
+        safe_incr();
+    }
+
+    // flush adds the pending increments to the shared counter.
+    void flush()
+    {
+        if (pending != 0) {
+            shared.add(pending);
+            pending = 0;
+        }
+    }
+
+    // value returns the shared count plus the increments pending here.
+    int value() const
+    {
+        return shared.value() + pending;
+    }
+
+private:
+    C& shared;
+    int batch_size;
+    int pending = 0;
+};
@@ -0,0 +1,74 @@
+// Benchmark Counter increments with contention from many threads.
+#include <cstddef>
+#include <optional>
+
+#include "counter.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Each iteration is 1e5 increments split across state.arg() threads.
+constexpr int num_incr = 100'000;
+
+// bench_incr runs func(counter, n) on state.arg() threads to make n
+// increments each, sharing one counter of type C. The threads are started
+// once, and each iteration releases them on a new counter.
+template <typename C, typename Func>
+void bench_incr(timeit::State& state, Func func)
+{
+    int num_threads = state.arg();
+    std::optional<C> counter;
+    timeit::Workers workers{static_cast<std::size_t>(num_threads),
+                            [&counter, &func, num_threads](std::size_t) {
+                                func(*counter, num_incr / num_threads);
+                            }};
+    while (state.keep_running()) {
+        counter.emplace();
+        workers.run();
+        timeit::do_not_optimize(counter->value());
+    }
+    state.set_items_processed(num_incr);
+}
+
+// safe_incr makes n increments of counter with safe_incr.
+template <typename C>
+void safe_incr(C& counter, int n)
+{
+    for (int i = 0; i != n; ++i) {
+        counter.safe_incr();
+    }
+}
+
+// Thread scaling from 1 thread to 2x the cores of a large machine.
+#define COUNTER_THREADS 1, 2, 4, 8, 16, 32
+
+TIMEIT_BENCHMARK_ARGS("[counter:safe_incr]", COUNTER_THREADS)
+{
+    bench_incr<Counter>(state, safe_incr<Counter>);
+}
+
+TIMEIT_BENCHMARK_ARGS("[counter:AtomicCounter]", COUNTER_THREADS)
+{
+    bench_incr<AtomicCounter>(state, safe_incr<AtomicCounter>);
+}
+
+TIMEIT_BENCHMARK_ARGS("[counter:ShardedCounter]", COUNTER_THREADS)
+{
+    bench_incr<ShardedCounter>(state, safe_incr<ShardedCounter>);
+}
+
+TIMEIT_BENCHMARK_ARGS("[counter:BatchedCounter<Counter>]", COUNTER_THREADS)
+{
+    bench_incr<Counter>(state, [](Counter& shared, int n) {
+        BatchedCounter<Counter> local{shared};
+        safe_incr(local, n);
+    });
+}
+
+TIMEIT_BENCHMARK_ARGS("[counter:BatchedCounter<AtomicCounter>]", COUNTER_THREADS)
+{
+    bench_incr<AtomicCounter>(state, [](AtomicCounter& shared, int n) {
+        BatchedCounter<AtomicCounter> local{shared};
+        safe_incr(local, n);
+    });
+}
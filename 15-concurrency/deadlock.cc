@@ -1,45 +1,16 @@
 // Demonstrate use of scoped_lock with pairs of locks to avoid deadlock.
+#include <atomic>
 #include <functional>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 #include <thread>
 
+#include "deadlock.h"
+
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 
-// Message provides thread-safe comparison of message.
-class Message
-{
-public:
-    Message(const std::string& body)
-        : body(body)
-    { }
-
-    friend bool safe_equal(const Message& m1, const Message& m2);
-    friend bool unsafe_equal(const Message& m1, const Message& m2);
-
-private:
-    mutable std::mutex m;
-    std::string body;
-};
-
-// thread-safe comparison of messages.
-bool safe_equal(const Message& m1, const Message& m2)
-{
-    // To avoid deadlock, acquire both locks.
-    std::scoped_lock guard{m1.m, m2.m};
-    return m1.body == m2.body;
-}
-
-// thread-unsafe comparison of messages.
-bool unsafe_equal(const Message& m1, const Message& m2)
-{
-    // Acquiring locks separately is only safe when messages passed in consistent order.
-    std::scoped_lock guard1{m1.m};
-    std::scoped_lock guard2{m2.m};
-    return m1.body == m2.body;
-}
-
 TEST_CASE("[deadlock]")
 {
     // thread_func compares shared memory messages.
@@ -114,3 +85,82 @@ TEST_CASE("[deadlock]")
         // Passing messages in inconsistent order using thread-unsafe comparison will deadlock.
     }
 }
+
+TEST_CASE("[deadlock avoidance]")
+{
+    // compare_and_set compares messages in both orders while they are rewritten.
+    auto compare_and_set = [] (auto& m1, auto& m2, auto equal) {
+        constexpr int num_repeat = 200'000;
+        auto thread_func = [&](bool swap) {
+            for (int n = 0; n != num_repeat; ++n) {
+                static_cast<void>(swap ? equal(m2, m1) : equal(m1, m2));
+                if (n % 100 == 0) {
+                    (swap ? m2 : m1).set(n % 200 == 0 ? "hello" : "world");
+                }
+            }
+        };
+        std::thread t1{thread_func, false};
+        std::thread t2{thread_func, true};
+        t1.join();
+        t2.join();
+    };
+
+    SUBCASE("ordered_equal")
+    {
+        Message m1{"hello"};
+        Message m2{"world"};
+        REQUIRE(ordered_equal(m1, m1));
+        REQUIRE_FALSE(ordered_equal(m1, m2));
+        compare_and_set(m1, m2, ordered_equal);
+        REQUIRE(true == true); // Reached without deadlock.
+    }
+
+    SUBCASE("ranked_equal")
+    {
+        RankedMessage m1{"hello"};
+        RankedMessage m2{"world"};
+        REQUIRE(ranked_equal(m1, m1));
+        REQUIRE_FALSE(ranked_equal(m1, m2));
+        compare_and_set(m1, m2, ranked_equal);
+        REQUIRE(true == true); // Reached without deadlock.
+    }
+
+    SUBCASE("seqlock_equal")
+    {
+        SeqlockMessage<> m1{"hello"};
+        SeqlockMessage<> m2{"world"};
+        REQUIRE(seqlock_equal(m1, m1));
+        REQUIRE_FALSE(seqlock_equal(m1, m2));
+        m2.set("hello");
+        REQUIRE(seqlock_equal(m1, m2));
+        REQUIRE(m2.body() == "hello");
+        REQUIRE_THROWS_AS(m1.set(std::string(65, 'x')), std::length_error);
+        compare_and_set(m1, m2, seqlock_equal<64>);
+
+        // Reads never observe a torn body while another thread rewrites it.
+        // The bodies span several words, which are stored one by one.
+        std::string hello, world;
+        for (int i = 0; i != 12; ++i) {
+            hello += "hello";
+            world += "world";
+        }
+        m1.set(hello);
+        std::atomic<bool> stop{false};
+        std::thread writer{[&] {
+            for (int n = 0; !stop; ++n) {
+                m1.set(n % 2 == 0 ? world : hello);
+            }
+        }};
+        // Join the writer even when a read fails.
+        struct Join
+        {
+            std::atomic<bool>& stop;
+            std::thread& t;
+            ~Join() { stop = true; t.join(); }
+        } join{stop, writer};
+        for (int n = 0; n != 100'000; ++n) {
+            auto body = m1.body();
+            REQUIRE((body == hello || body == world));
+        }
+    }
+}
@@ -0,0 +1,216 @@
+// Compare pairs of messages under locks without deadlock.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "locks.h"
+
+// Message provides thread-safe comparison of message.
+class Message
+{
+public:
+    Message(const std::string& body)
+        : body(body)
+    { }
+
+    void set(const std::string& s)
+    {
+        std::scoped_lock guard{m};
+        body = s;
+    }
+
+    friend bool safe_equal(const Message& m1, const Message& m2);
+    friend bool unsafe_equal(const Message& m1, const Message& m2);
+    friend bool ordered_equal(const Message& m1, const Message& m2);
+
+private:
+    mutable std::mutex m;
+    std::string body;
+};
+
+// thread-safe comparison of messages.
+inline bool safe_equal(const Message& m1, const Message& m2)
+{
+    // To avoid deadlock, acquire both locks.
+    std::scoped_lock guard{m1.m, m2.m};
+    return m1.body == m2.body;
+}
+
+// thread-unsafe comparison of messages.
+inline bool unsafe_equal(const Message& m1, const Message& m2)
+{
+    // Acquiring locks separately is only safe when messages passed in consistent order.
+    std::scoped_lock guard1{m1.m};
+    std::scoped_lock guard2{m2.m};
+    return m1.body == m2.body;
+}
+
+// thread-safe comparison of messages that acquires the locks in the order of
+// their addresses. All threads agree on the order, so it cannot deadlock and,
+// unlike scoped_lock, never backs off and retries.
+inline bool ordered_equal(const Message& m1, const Message& m2)
+{
+    if (&m1 == &m2) {
+        return true; // Locking the same mutex twice would deadlock.
+    }
+    // std::less is a total order on pointers, unlike the builtin <.
+    bool first = std::less<const Message*>{}(&m1, &m2);
+    std::scoped_lock guard1{first ? m1.m : m2.m};
+    std::scoped_lock guard2{first ? m2.m : m1.m};
+    return m1.body == m2.body;
+}
+
+// RankedMessage is a Message locked in the order of a rank, which unlike an
+// address is stable across runs, so the lock order can be logged and checked.
+class RankedMessage
+{
+public:
+    RankedMessage(const std::string& body)
+        : body(body), rank(next_rank++)
+    { }
+
+    void set(const std::string& s)
+    {
+        std::scoped_lock guard{m};
+        body = s;
+    }
+
+    friend bool ranked_equal(const RankedMessage& m1, const RankedMessage& m2);
+
+private:
+    static inline std::atomic<std::uint64_t> next_rank{0};
+
+    mutable std::mutex m;
+    std::string body;
+    std::uint64_t rank;
+};
+
+// thread-safe comparison of messages that acquires the locks in rank order.
+inline bool ranked_equal(const RankedMessage& m1, const RankedMessage& m2)
+{
+    if (m1.rank == m2.rank) {
+        return true; // Same message.
+    }
+    bool first = m1.rank < m2.rank;
+    std::scoped_lock guard1{first ? m1.m : m2.m};
+    std::scoped_lock guard2{first ? m2.m : m1.m};
+    return m1.body == m2.body;
+}
+
+// SeqlockMessage is a message of at most N bytes read without locks. Writers
+// serialize on a mutex and make the sequence number odd while they write.
+// Readers copy the body and retry if the sequence number was odd or changed
+// meanwhile. The body is stored in relaxed atomic words, so that a read racing
+// with a write is a stale copy rather than a data race.
+template <std::size_t N = 64>
+class SeqlockMessage
+{
+public:
+    SeqlockMessage(std::string_view body)
+    {
+        set(body);
+    }
+
+    // set replaces the body, std::length_error if longer than N.
+    void set(std::string_view s)
+    {
+        if (s.size() > N) {
+            throw std::length_error{"SeqlockMessage: body too long"};
+        }
+        Words w{};
+        std::memcpy(w.data, s.data(), s.size());
+
+        std::scoped_lock guard{m};
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        length.store(s.size(), std::memory_order_relaxed);
+        for (std::size_t i = 0; i != num_words; ++i) {
+            words[i].store(w.data[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // body returns a consistent copy of the body.
+    std::string body() const
+    {
+        Words w;
+        std::size_t len;
+        for (;;) {
+            auto seq = begin_read();
+            len = read(w);
+            if (end_read(seq)) {
+                break;
+            }
+        }
+        return std::string(reinterpret_cast<const char*>(w.data), len);
+    }
+
+    template <std::size_t M>
+    friend bool seqlock_equal(const SeqlockMessage<M>& m1, const SeqlockMessage<M>& m2);
+
+private:
+    static constexpr std::size_t num_words = (N + 7) / 8;
+
+    struct Words
+    {
+        std::uint64_t data[num_words];
+    };
+
+    // begin_read waits for writers to finish and returns the sequence number.
+    std::uint64_t begin_read() const
+    {
+        std::uint64_t seq;
+        _spin_until([this, &seq] {
+            seq = sequence.load(std::memory_order_acquire);
+            return seq % 2 == 0;
+        });
+        return seq;
+    }
+
+    // read copies the body to w and returns its length.
+    std::size_t read(Words& w) const
+    {
+        for (std::size_t i = 0; i != num_words; ++i) {
+            w.data[i] = words[i].load(std::memory_order_relaxed);
+        }
+        return length.load(std::memory_order_relaxed);
+    }
+
+    // end_read returns true when no writer started since begin_read.
+    bool end_read(std::uint64_t seq) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence.load(std::memory_order_relaxed) == seq;
+    }
+
+    std::mutex m; // Serializes writers.
+    std::atomic<std::uint64_t> sequence{0};
+    std::atomic<std::size_t> length{0};
+    std::atomic<std::uint64_t> words[num_words] = {};
+};
+
+// thread-safe comparison of messages that takes no locks. Both copies are
+// validated after both are read, so they held together at one instant.
+template <std::size_t N>
+bool seqlock_equal(const SeqlockMessage<N>& m1, const SeqlockMessage<N>& m2)
+{
+    typename SeqlockMessage<N>::Words w1, w2;
+    for (;;) {
+        auto seq1 = m1.begin_read();
+        auto seq2 = m2.begin_read();
+        std::size_t len1 = m1.read(w1);
+        std::size_t len2 = m2.read(w2);
+        if (m1.end_read(seq1) && m2.end_read(seq2)) {
+            return len1 == len2 && std::memcmp(w1.data, w2.data, len1) == 0;
+        }
+    }
+}
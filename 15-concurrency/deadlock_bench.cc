@@ -0,0 +1,78 @@
+// Benchmark comparisons of random pairs of messages shared by many threads.
+#include <cstddef>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deadlock.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// Each iteration is num_ops operations on num_messages messages split across
+// state.arg() threads, where 1 in 100 operations rewrites a message and the
+// others compare a random pair of distinct messages.
+constexpr int num_ops = 100'000;
+constexpr int num_messages = 64;
+
+template <typename Msg, typename Equal>
+void bench_compare(timeit::State& state, Equal equal)
+{
+    std::deque<Msg> messages; // Messages are not movable.
+    for (int i = 0; i != num_messages; ++i) {
+        messages.emplace_back(i % 2 == 0 ? "hello" : "world");
+    }
+
+    // The threads are started once and each iteration releases them.
+    std::size_t num_threads = state.arg();
+    // Each engine on its own cache line, so the threads do not share them.
+    struct alignas(64) Gen
+    {
+        std::default_random_engine engine;
+    };
+    std::vector<Gen> gens;
+    for (std::size_t t = 0; t != num_threads; ++t) {
+        gens.push_back({std::default_random_engine(t)});
+    }
+    timeit::Workers workers{num_threads, [&](std::size_t t) {
+        std::uniform_int_distribution<int> pick{0, num_messages - 1};
+        int num_equal = 0;
+        for (int n = 0; n != num_ops / static_cast<int>(num_threads); ++n) {
+            int i = pick(gens[t].engine);
+            int j = (i + 1 + pick(gens[t].engine) % (num_messages - 1)) % num_messages;
+            if (n % 100 == 0) {
+                messages[i].set(n % 200 == 0 ? "hello" : "world");
+            } else {
+                num_equal += equal(messages[i], messages[j]);
+            }
+        }
+        timeit::do_not_optimize(num_equal);
+    }};
+    while (state.keep_running()) {
+        workers.run();
+    }
+    state.set_items_processed(num_ops);
+}
+
+#define COMPARE_THREADS 2, 4, 8, 16, 32, 64
+
+TIMEIT_BENCHMARK_ARGS("[compare:safe_equal]", COMPARE_THREADS)
+{
+    bench_compare<Message>(state, safe_equal);
+}
+
+TIMEIT_BENCHMARK_ARGS("[compare:ordered_equal]", COMPARE_THREADS)
+{
+    bench_compare<Message>(state, ordered_equal);
+}
+
+TIMEIT_BENCHMARK_ARGS("[compare:ranked_equal]", COMPARE_THREADS)
+{
+    bench_compare<RankedMessage>(state, ranked_equal);
+}
+
+TIMEIT_BENCHMARK_ARGS("[compare:seqlock_equal]", COMPARE_THREADS)
+{
+    bench_compare<SeqlockMessage<>>(state, seqlock_equal<64>);
+}
@@ -0,0 +1,124 @@
+// Communicate events to listeners with threads or with a thread pool.
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "threadpool.h"
+
+// EventSource starts a thread per listener waiting on a condition_variable.
+class EventSource
+{
+public:
+    EventSource() = default;
+    EventSource(const EventSource&) = delete;
+    EventSource& operator=(const EventSource&) = delete;
+
+    // listen attaches a one-time callback function to events from this source.
+    void listen(int id, std::function<void(int)> func)
+    {
+        // handler_func invokes the callback after trigger.
+        // NOTE: Capture `this` and refer to members without this.
+        auto handler_func = [this](int id, std::function<void(int)> func, std::promise<void> started){
+            std::unique_lock lck{m};
+            started.set_value(); // Thread started, lock acquired, about to wait.
+            cond.wait(lck);      // Unlock and wait for notification.
+            func(id);            // Invoke callback.
+        };
+
+        // Start a thread waiting for next event.
+        std::promise<void> started;
+        std::future<void> started_future = started.get_future();
+        callbacks.emplace_back(handler_func, id, func, std::move(started));
+
+        // Wait until thread is started before returning.
+        started_future.wait();
+    }
+
+    // trigger notifies all listeners of event.
+    void trigger()
+    {
+        // Acquire the lock before notification to avoid race with listener.
+        std::unique_lock lck{m};
+        cond.notify_all();
+    }
+
+    // wait waits for all listener callbacks to finish.
+    void wait()
+    {
+        for (std::size_t i = 0; i < callbacks.size(); ++i) {
+            callbacks[i].join();
+        }
+    }
+
+private:
+    std::condition_variable cond;
+    std::mutex m;
+    std::vector<std::thread> callbacks;
+};
+
+// PooledEventSource has the interface of EventSource, but parks listeners as
+// callbacks instead of threads, and trigger submits them to a ThreadPool. A
+// listener costs the size of its callback rather than a thread and its stack.
+class PooledEventSource
+{
+public:
+    explicit PooledEventSource(ThreadPool& pool) : pool{pool} {}
+    PooledEventSource(const PooledEventSource&) = delete;
+    PooledEventSource& operator=(const PooledEventSource&) = delete;
+
+    // Destructor waits for the callbacks that are running, they refer to this.
+    ~PooledEventSource()
+    {
+        wait();
+    }
+
+    // listen attaches a one-time callback function to events from this source.
+    void listen(int id, std::function<void(int)> func)
+    {
+        std::scoped_lock<std::mutex> lck{m};
+        listeners.emplace_back(id, std::move(func));
+    }
+
+    // trigger submits the callbacks of all listeners to the pool.
+    void trigger()
+    {
+        std::vector<Listener> fired;
+        {
+            std::scoped_lock<std::mutex> lck{m};
+            std::swap(fired, listeners);
+            pending += fired.size();
+        }
+        for (auto& l : fired) {
+            pool.submit([this, l = std::move(l)] {
+                l.second(l.first); // Invoke callback.
+                std::scoped_lock<std::mutex> lck{m};
+                if (--pending == 0) {
+                    done.notify_all();
+                }
+            });
+        }
+    }
+
+    // wait waits for all triggered callbacks to finish.
+    void wait()
+    {
+        std::unique_lock<std::mutex> lck{m};
+        done.wait(lck, [this] { return pending == 0; });
+    }
+
+private:
+    using Listener = std::pair<int, std::function<void(int)>>;
+
+    ThreadPool& pool;
+    std::mutex m;
+    std::condition_variable done;
+    std::vector<Listener> listeners;
+    std::size_t pending = 0;
+};
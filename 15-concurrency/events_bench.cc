@@ -0,0 +1,83 @@
+// Benchmark EventSource with a thread per listener against PooledEventSource.
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "events.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// proc_status_kb returns the value in kB of field, e.g. "VmRSS:", of
+// /proc/self/status, or 0 where not available.
+double proc_status_kb(const std::string& field)
+{
+    std::ifstream ifs{"/proc/self/status"};
+    for (std::string key; ifs >> key;) {
+        if (key == field) {
+            double kb = 0;
+            ifs >> kb;
+            return kb;
+        }
+        std::getline(ifs, key);
+    }
+    return 0;
+}
+
+// bench_events measures the latency from trigger until every one of
+// state.arg() listeners has run its callback, and the resident and virtual
+// memory of each parked listener.
+template <typename Events>
+void bench_events(timeit::State& state, Events& events)
+{
+    int num_listeners = state.arg();
+    while (state.keep_running()) {
+        state.pause_timing();
+        double rss = proc_status_kb("VmRSS:");
+        double vm = proc_status_kb("VmSize:");
+        for (int id = 0; id != num_listeners; ++id) {
+            events.listen(id, [](int id) { timeit::do_not_optimize(id); });
+        }
+        // Freed thread stacks are reused, so report the largest growth.
+        auto& rss_kb = state.counters["rss_kb/listener"];
+        auto& vm_kb = state.counters["vm_kb/listener"];
+        rss_kb = std::max(rss_kb, (proc_status_kb("VmRSS:") - rss) / num_listeners);
+        vm_kb = std::max(vm_kb, (proc_status_kb("VmSize:") - vm) / num_listeners);
+        state.resume_timing();
+
+        events.trigger();
+        events.wait();
+    }
+    state.set_items_processed(num_listeners);
+}
+
+// EventSource::wait joins its threads, so a source is used once.
+struct OneShotEventSource
+{
+    std::unique_ptr<EventSource> events;
+    void listen(int id, std::function<void(int)> func)
+    {
+        if (!events) {
+            events = std::make_unique<EventSource>();
+        }
+        events->listen(id, std::move(func));
+    }
+    void trigger() { events->trigger(); }
+    void wait() { events->wait(); events.reset(); }
+};
+
+TIMEIT_BENCHMARK_ARGS("[events:EventSource]", 10, 100, 1000)
+{
+    OneShotEventSource events;
+    bench_events(state, events);
+}
+
+TIMEIT_BENCHMARK_ARGS("[events:PooledEventSource]", 10, 100, 1000, 10'000)
+{
+    ThreadPool pool;
+    PooledEventSource events{pool};
+    bench_events(state, events);
+}
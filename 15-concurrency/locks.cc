@@ -0,0 +1,80 @@
+// Demonstrate ticket, MCS and spin-then-futex locks.
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "locks.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+// count_locked returns the count after num_threads threads each increment it
+// num_repeat times while holding lock.
+template <typename Lock>
+int count_locked(Lock& lock, int num_threads, int num_repeat)
+{
+    int count = 0;
+    std::vector<std::thread> workers;
+    for (int i = 0; i != num_threads; ++i) {
+        workers.emplace_back([&lock, &count, num_repeat] {
+            for (int n = 0; n != num_repeat; ++n) {
+                std::scoped_lock<Lock> guard{lock};
+                ++count;
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    return count;
+}
+
+// check_lock checks mutual exclusion and the std::mutex interface of Lock.
+template <typename Lock>
+void check_lock()
+{
+    SUBCASE("mutual exclusion")
+    {
+        Lock lock;
+        REQUIRE(count_locked(lock, 4, 100'000) == 400'000);
+    }
+
+    SUBCASE("try_lock")
+    {
+        Lock lock;
+        REQUIRE(lock.try_lock());
+        REQUIRE_FALSE(lock.try_lock());
+        lock.unlock();
+        REQUIRE(lock.try_lock());
+        lock.unlock();
+    }
+
+    SUBCASE("scoped_lock of two locks")
+    {
+        Lock a, b;
+        {
+            std::scoped_lock guard{a, b};
+            REQUIRE_FALSE(a.try_lock());
+            REQUIRE_FALSE(b.try_lock());
+        }
+        REQUIRE(a.try_lock());
+        REQUIRE(b.try_lock());
+        a.unlock();
+        b.unlock();
+    }
+}
+
+TEST_CASE("[TicketLock]")
+{
+    check_lock<TicketLock>();
+}
+
+TEST_CASE("[McsLock]")
+{
+    check_lock<McsLock>();
+}
+
+TEST_CASE("[SpinFutexLock]")
+{
+    check_lock<SpinFutexLock>();
+}
@@ -0,0 +1,241 @@
+// Mutexes with the std::mutex interface trading fairness against latency.
+//
+// TicketLock and McsLock grant the lock in arrival order, so no thread can
+// starve. TicketLock waiters all spin on one shared counter, while McsLock
+// waiters each spin on their own queue node, which keeps the cache line
+// traffic of a handoff constant in the number of waiters. SpinFutexLock is not
+// fair, but spins briefly before sleeping in the kernel, so it neither burns
+// CPU under long waits nor pays for a syscall under short ones.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// _cpu_relax hints to the processor that the thread is spinning.
+inline void _cpu_relax()
+{
+#if defined(__SSE2__)
+    _mm_pause();
+#endif
+}
+
+// _spin_until spins until pred() with a pause, yielding the processor once
+// spinning has gone on long enough that the lock holder may be descheduled.
+template <typename Pred>
+void _spin_until(Pred pred)
+{
+    for (int spins = 0; !pred(); ++spins) {
+        if (spins < 128) {
+            _cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// TicketLock grants the lock in the order of the tickets drawn by lock.
+class TicketLock
+{
+public:
+    void lock()
+    {
+        auto ticket = next.fetch_add(1, std::memory_order_relaxed);
+        _spin_until([this, ticket] {
+            return serving.load(std::memory_order_acquire) == ticket;
+        });
+    }
+
+    bool try_lock()
+    {
+        auto s = serving.load(std::memory_order_relaxed);
+        auto n = s;
+        return next.compare_exchange_strong(n, s + 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed);
+    }
+
+    void unlock()
+    {
+        serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    alignas(64) std::atomic<std::uint32_t> next{0};
+    alignas(64) std::atomic<std::uint32_t> serving{0};
+};
+
+// McsLock is the queue lock of Mellor-Crummey and Scott, "Algorithms for
+// Scalable Synchronization on Shared-Memory Multiprocessors", 1991. Waiters
+// form a linked list of nodes and each waits on its own node until its
+// predecessor hands the lock over. The nodes come from a pool of the locking
+// thread, so lock and unlock keep the std::mutex interface.
+class McsLock
+{
+public:
+    void lock()
+    {
+        Node* n = acquire_node();
+        Node* pred = tail.exchange(n, std::memory_order_acq_rel);
+        if (pred != nullptr) {
+            pred->next.store(n, std::memory_order_release);
+            _spin_until([n] { return !n->locked.load(std::memory_order_acquire); });
+        }
+        holder = n;
+    }
+
+    bool try_lock()
+    {
+        Node* n = acquire_node();
+        Node* expected = nullptr;
+        if (tail.compare_exchange_strong(expected, n, std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+            holder = n;
+            return true;
+        }
+        release_node(n);
+        return false;
+    }
+
+    void unlock()
+    {
+        Node* n = holder;
+        Node* succ = n->next.load(std::memory_order_acquire);
+        if (succ == nullptr) {
+            // No known successor, release unless one is joining the queue.
+            Node* expected = n;
+            if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+                release_node(n);
+                return;
+            }
+            _spin_until([n, &succ] {
+                succ = n->next.load(std::memory_order_acquire);
+                return succ != nullptr;
+            });
+        }
+        succ->locked.store(false, std::memory_order_release);
+        release_node(n);
+    }
+
+private:
+    struct alignas(64) Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool> locked{true};
+    };
+
+    // NodePool holds the free nodes of a thread, which may hold many locks.
+    struct NodePool
+    {
+        std::vector<Node*> nodes;
+        ~NodePool()
+        {
+            for (Node* n : nodes) {
+                delete n;
+            }
+        }
+    };
+
+    static std::vector<Node*>& free_nodes()
+    {
+        thread_local NodePool pool;
+        return pool.nodes;
+    }
+
+    static Node* acquire_node()
+    {
+        auto& nodes = free_nodes();
+        Node* n = nodes.empty() ? new Node : nodes.back();
+        if (!nodes.empty()) {
+            nodes.pop_back();
+        }
+        n->next.store(nullptr, std::memory_order_relaxed);
+        n->locked.store(true, std::memory_order_relaxed);
+        return n;
+    }
+
+    // release_node returns n to the pool once no other thread refers to it.
+    static void release_node(Node* n)
+    {
+        free_nodes().push_back(n);
+    }
+
+    std::atomic<Node*> tail{nullptr};
+    Node* holder = nullptr; // Node of the thread holding the lock.
+};
+
+// SpinFutexLock spins for a while to acquire the lock and then sleeps on a
+// futex, following mutex 3 of Drepper, "Futexes Are Tricky", 2011.
+// state is 0 when unlocked, 1 when locked and 2 when locked with sleepers.
+class SpinFutexLock
+{
+public:
+    void lock()
+    {
+        for (int spins = 0; spins != max_spins; ++spins) {
+            int c = 0;
+            if (state.compare_exchange_weak(c, 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return;
+            }
+            _cpu_relax();
+        }
+        // Mark that there are sleepers before sleeping.
+        int c = state.exchange(2, std::memory_order_acquire);
+        while (c != 0) {
+            wait(2);
+            c = state.exchange(2, std::memory_order_acquire);
+        }
+    }
+
+    bool try_lock()
+    {
+        int c = 0;
+        return state.compare_exchange_strong(c, 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void unlock()
+    {
+        if (state.exchange(0, std::memory_order_release) == 2) {
+            wake_one();
+        }
+    }
+
+private:
+    static constexpr int max_spins = 100;
+
+    // wait sleeps while state == expected.
+    void wait(int expected)
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAIT_PRIVATE,
+                  expected, nullptr, nullptr, 0);
+#else
+        (void)expected;
+        std::this_thread::yield();
+#endif
+    }
+
+    void wake_one()
+    {
+#if defined(__linux__)
+        ::syscall(SYS_futex, reinterpret_cast<int*>(&state), FUTEX_WAKE_PRIVATE,
+                  1, nullptr, nullptr, 0);
+#endif
+    }
+
+    static_assert(sizeof(std::atomic<int>) == sizeof(int), "futex requires a plain int");
+    std::atomic<int> state{0};
+};
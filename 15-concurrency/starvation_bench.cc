@@ -0,0 +1,119 @@
+// Benchmark throughput and fairness of std::mutex against the locks in locks.h.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "locks.h"
+
+#define TIMEIT_CONFIG_IMPLEMENT_WITH_MAIN
+#include "../13-utilities/timeit.h"
+
+// work spins for n units of a short critical section.
+void work(int n)
+{
+    for (int i = 0; i != n; ++i) {
+        timeit::clobber_memory();
+    }
+}
+
+// Each iteration is num_acquire acquisitions of a lock shared by state.arg()
+// threads, so the time measures throughput. Threads race for acquisitions, so
+// fairness is the ratio of the acquisitions of the luckiest and unluckiest
+// thread over all iterations, 1 when fair. The threads are started once, and
+// each iteration waits for all of them to be running before the first
+// acquisition, so that the first thread released does not take the
+// acquisitions of those not yet awake.
+constexpr int num_acquire = 100'000;
+
+template <typename Lock>
+void bench_lock(timeit::State& state)
+{
+    int num_threads = state.arg();
+    std::vector<std::int64_t> acquired(num_threads);
+    std::optional<Lock> lock;
+    std::int64_t remaining = 0; // Guarded by lock.
+    std::atomic<int> running{0};
+    timeit::Workers workers{static_cast<std::size_t>(num_threads), [&](std::size_t t) {
+        running.fetch_add(1);
+        while (running.load() != num_threads) {
+            std::this_thread::yield();
+        }
+        std::int64_t n = 0;
+        for (;;) {
+            std::scoped_lock<Lock> guard{*lock};
+            if (remaining == 0) {
+                break;
+            }
+            --remaining;
+            ++n;
+            work(10);
+        }
+        acquired[t] += n;
+    }};
+    while (state.keep_running()) {
+        lock.emplace();
+        remaining = num_acquire;
+        running = 0;
+        workers.run();
+    }
+    auto [lo, hi] = std::minmax_element(acquired.begin(), acquired.end());
+    state.counters["max/min"] = static_cast<double>(*hi) / std::max<std::int64_t>(*lo, 1);
+    state.set_items_processed(num_acquire);
+}
+
+#define LOCK_THREADS 1, 2, 4, 8
+
+TIMEIT_BENCHMARK_ARGS("[lock:std::mutex]", LOCK_THREADS) { bench_lock<std::mutex>(state); }
+TIMEIT_BENCHMARK_ARGS("[lock:TicketLock]", LOCK_THREADS) { bench_lock<TicketLock>(state); }
+TIMEIT_BENCHMARK_ARGS("[lock:McsLock]", LOCK_THREADS) { bench_lock<McsLock>(state); }
+TIMEIT_BENCHMARK_ARGS("[lock:SpinFutexLock]", LOCK_THREADS) { bench_lock<SpinFutexLock>(state); }
+
+// bench_starvation repeats the greedy and polite workers of starvation.cc for
+// state.arg() milliseconds: greedy holds the lock once for 10 units of work,
+// polite 10 times for 1 unit. Both do the same work, so greedy/polite is 1
+// for a lock that does not favor the thread that released it. A third thread
+// stops the other two after the runtime, so that all three are started once.
+template <typename Lock>
+void bench_starvation(timeit::State& state)
+{
+    auto runtime = std::chrono::milliseconds{state.arg()};
+    std::optional<Lock> lock;
+    std::atomic<bool> stop{false};
+    std::int64_t work_count[2] = {0, 0}; // Greedy and polite.
+    timeit::Workers workers{3, [&](std::size_t t) {
+        if (t == 2) {
+            std::this_thread::sleep_for(runtime);
+            stop = true;
+            return;
+        }
+        int hold = t == 0 ? 10 : 1;
+        int num_hold = t == 0 ? 1 : 10;
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (int i = 0; i != num_hold; ++i) {
+                std::scoped_lock<Lock> guard{*lock};
+                work(hold);
+            }
+            ++work_count[t];
+        }
+    }};
+    std::int64_t num_iter = 0;
+    while (state.keep_running()) {
+        lock.emplace();
+        stop = false;
+        workers.run();
+        ++num_iter;
+    }
+    state.counters["greedy/polite"] =
+        static_cast<double>(work_count[0]) / std::max<std::int64_t>(work_count[1], 1);
+    state.counters["work/s"] = (work_count[0] + work_count[1]) * 1e3 / state.arg() / num_iter;
+}
+
+TIMEIT_BENCHMARK_ARGS("[starvation:std::mutex]", 50) { bench_starvation<std::mutex>(state); }
+TIMEIT_BENCHMARK_ARGS("[starvation:TicketLock]", 50) { bench_starvation<TicketLock>(state); }
+TIMEIT_BENCHMARK_ARGS("[starvation:McsLock]", 50) { bench_starvation<McsLock>(state); }
+TIMEIT_BENCHMARK_ARGS("[starvation:SpinFutexLock]", 50) { bench_starvation<SpinFutexLock>(state); }
@@ -0,0 +1,119 @@
+// Demonstrate a work-stealing thread pool.
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "threadpool.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest/doctest.h"
+
+TEST_CASE("[ChaseLevDeque]")
+{
+    SUBCASE("owner is last in first out, thief first in first out")
+    {
+        ChaseLevDeque<int> dq{2};
+        for (int i = 0; i != 5; ++i) {
+            dq.push(i); // Grows past the initial capacity.
+        }
+        REQUIRE(dq.size() == 5);
+        REQUIRE(dq.take() == 4);
+        REQUIRE(dq.steal() == 0);
+        REQUIRE(dq.take() == 3);
+        REQUIRE(dq.steal() == 1);
+        REQUIRE(dq.take() == 2);
+        REQUIRE_FALSE(dq.take());
+        REQUIRE_FALSE(dq.steal());
+    }
+
+    SUBCASE("every element is taken or stolen exactly once")
+    {
+        constexpr int num_items = 100'000;
+        constexpr int num_thieves = 3;
+        ChaseLevDeque<int> dq;
+        std::atomic<bool> done{false};
+        std::vector<std::vector<int>> stolen(num_thieves);
+        std::vector<std::thread> thieves;
+        for (int k = 0; k != num_thieves; ++k) {
+            thieves.emplace_back([&, k] {
+                while (!done.load() || dq.size() > 0) {
+                    if (auto x = dq.steal()) {
+                        stolen[k].push_back(*x);
+                    }
+                }
+            });
+        }
+
+        std::vector<int> taken;
+        for (int i = 0; i != num_items; ++i) {
+            dq.push(i);
+            if (i % 3 == 0) {
+                if (auto x = dq.take()) {
+                    taken.push_back(*x);
+                }
+            }
+        }
+        done.store(true);
+        for (auto& t : thieves) {
+            t.join();
+        }
+
+        std::multiset<int> all(taken.begin(), taken.end());
+        for (const auto& s : stolen) {
+            all.insert(s.begin(), s.end());
+        }
+        REQUIRE(all.size() == num_items);
+        REQUIRE(std::set<int>(all.begin(), all.end()).size() == num_items);
+    }
+}
+
+TEST_CASE("[ThreadPool]")
+{
+    SUBCASE("runs every task")
+    {
+        std::atomic<int> count{0};
+        {
+            ThreadPool pool{4};
+            for (int i = 0; i != 10'000; ++i) {
+                pool.submit([&count] { ++count; });
+            }
+        } // Destructor runs the submitted tasks.
+        REQUIRE(count.load() == 10'000);
+    }
+
+    SUBCASE("tasks may be move only")
+    {
+        std::atomic<int> sum{0};
+        {
+            ThreadPool pool{2};
+            for (int i = 0; i != 100; ++i) {
+                pool.submit([&sum, p = std::make_unique<int>(i)] { sum += *p; });
+            }
+        }
+        REQUIRE(sum.load() == 4950);
+    }
+
+    SUBCASE("tasks submit tasks")
+    {
+        // Each task spawns its children onto the worker's own deque, from
+        // where idle workers steal them.
+        std::atomic<int> count{0};
+        {
+            std::function<void(int)> tree;
+            ThreadPool pool{4}; // Joined before tree is destroyed.
+            tree = [&](int depth) {
+                ++count;
+                if (depth > 0) {
+                    pool.submit([&tree, depth] { tree(depth - 1); });
+                    pool.submit([&tree, depth] { tree(depth - 1); });
+                }
+            };
+            pool.submit([&tree] { tree(12); });
+        }
+        REQUIRE(count.load() == (1 << 13) - 1);
+    }
+}
@@ -0,0 +1,305 @@
+// Fixed size thread pool with per-worker work-stealing deques.
+//
+// Each worker owns a Chase-Lev deque: the worker pushes and takes tasks at the
+// bottom without locks, while idle workers steal from the top with a single
+// compare-and-swap. Tasks submitted from outside the pool go through a shared
+// queue, and workers with nothing to run or steal sleep on a condition variable.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ChaseLevDeque is a growable single-owner, multi-thief deque of trivially
+// copyable values, following Le, Pop, Cohen and Zappa Nardelli, "Correct and
+// Efficient Work-Stealing for Weak Memory Models", PPoPP 2013.
+// push and take must only be called by the owner thread, steal by any thread.
+template <typename T>
+class ChaseLevDeque
+{
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    explicit ChaseLevDeque(std::size_t capacity = 64)
+    {
+        std::size_t n = 2;
+        while (n < capacity) {
+            n *= 2;
+        }
+        arrays.push_back(std::make_unique<Array>(n));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // push adds x at the bottom, growing the array when full.
+    void push(T x)
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+        if (b - t > static_cast<std::int64_t>(a->size()) - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, x);
+        // A release store rather than a release fence and a relaxed store,
+        // which publishes the same, but is understood by ThreadSanitizer.
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // take removes x from the bottom, last in first out.
+    std::optional<T> take()
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        std::optional<T> x = a->get(b);
+        if (t == b) {
+            // Last element, race with thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                x = std::nullopt;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return x;
+    }
+
+    // steal removes x from the top, first in first out. It returns nothing
+    // when the deque is empty or another thread won the race for x.
+    std::optional<T> steal()
+    {
+        std::int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return std::nullopt;
+        }
+        Array* a = array.load(std::memory_order_acquire);
+        T x = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return x;
+    }
+
+    // size returns an estimate of the number of elements.
+    std::size_t size() const
+    {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    // Array is a circular buffer indexed by the unbounded top and bottom.
+    class Array
+    {
+    public:
+        explicit Array(std::size_t n) : buf(n), mask(n - 1) {}
+
+        std::size_t size() const { return buf.size(); }
+
+        T get(std::int64_t i) const
+        {
+            return buf[static_cast<std::size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(std::int64_t i, T x)
+        {
+            buf[static_cast<std::size_t>(i) & mask].store(x, std::memory_order_relaxed);
+        }
+
+    private:
+        std::vector<std::atomic<T>> buf;
+        std::size_t mask;
+    };
+
+    // grow copies [t, b) to an array twice the size. Thieves may still read
+    // the old array, so it is kept until the deque is destroyed.
+    Array* grow(Array* a, std::int64_t t, std::int64_t b)
+    {
+        arrays.push_back(std::make_unique<Array>(a->size() * 2));
+        Array* bigger = arrays.back().get();
+        for (std::int64_t i = t; i != b; ++i) {
+            bigger->put(i, a->get(i));
+        }
+        array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top{0};
+    alignas(64) std::atomic<std::int64_t> bottom{0};
+    std::atomic<Array*> array{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays; // Owned by the owner thread.
+};
+
+// _TaskNode is a submitted task, allocated once with its callable in place.
+class _TaskNode
+{
+public:
+    virtual ~_TaskNode() = default;
+    virtual void run() = 0;
+};
+
+template <typename F>
+class _TaskNodeOf final : public _TaskNode
+{
+public:
+    explicit _TaskNodeOf(F f) : f(std::move(f)) {}
+    void run() override { f(); }
+
+private:
+    F f;
+};
+
+// ThreadPool runs submitted tasks on a fixed number of worker threads. Tasks
+// submitted by a worker go to its own deque without a lock, where they run
+// last in first out unless an idle worker steals them. The mutex guards only
+// the shared queue and the sleep of idle workers, so submit takes it only to
+// inject a task from outside the pool or to wake a sleeping worker.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t nthreads = std::max(1U, std::thread::hardware_concurrency()))
+    {
+        for (std::size_t i = 0; i != nthreads; ++i) {
+            deques.push_back(std::make_unique<ChaseLevDeque<_TaskNode*>>());
+        }
+        for (std::size_t i = 0; i != nthreads; ++i) {
+            workers.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Destructor runs the tasks already submitted and joins the workers.
+    ~ThreadPool()
+    {
+        {
+            std::scoped_lock<std::mutex> lck{m};
+            stop = true;
+        }
+        cond.notify_all();
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    // submit schedules task, any callable with no arguments, to run on one of
+    // the workers. The task is moved into a single allocation. A task must
+    // not throw: as for the function of a std::thread, an exception that
+    // leaves it calls std::terminate.
+    template <typename F>
+    void submit(F&& task)
+    {
+        _TaskNode* t = new _TaskNodeOf<std::decay_t<F>>{std::forward<F>(task)};
+        if (current_pool == this) {
+            deques[current_index]->push(t);
+        } else {
+            std::scoped_lock<std::mutex> lck{m};
+            injected.push_back(t);
+            injected_size.store(injected.size(), std::memory_order_release);
+        }
+        // queued is incremented before sleepers is read, and a worker
+        // increments sleepers before it reads queued, so either the worker
+        // sees the task or this sees the worker and wakes it.
+        queued.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) > 0) {
+            {
+                // Wait for the worker to release the mutex in cond.wait.
+                std::scoped_lock<std::mutex> lck{m};
+            }
+            cond.notify_one();
+        }
+    }
+
+    std::size_t size() const { return workers.size(); }
+
+private:
+    // find returns a task for worker i, from its own deque first, then the
+    // shared queue, then by stealing from the other workers.
+    _TaskNode* find(std::size_t i)
+    {
+        if (auto t = deques[i]->take()) {
+            return *t;
+        }
+        if (injected_size.load(std::memory_order_acquire) > 0) {
+            std::scoped_lock<std::mutex> lck{m};
+            if (!injected.empty()) {
+                _TaskNode* t = injected.front();
+                injected.pop_front();
+                injected_size.store(injected.size(), std::memory_order_release);
+                return t;
+            }
+        }
+        for (std::size_t k = 1; k != deques.size(); ++k) {
+            if (auto t = deques[(i + k) % deques.size()]->steal()) {
+                return *t;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(std::size_t i)
+    {
+        current_pool = this;
+        current_index = i;
+        for (;;) {
+            if (_TaskNode* t = find(i)) {
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                std::unique_ptr<_TaskNode> task{t};
+                task->run();
+                continue;
+            }
+            if (queued.load(std::memory_order_seq_cst) > 0) {
+                // A task is being pushed or taken elsewhere, look again.
+                std::this_thread::yield();
+                continue;
+            }
+            std::unique_lock<std::mutex> lck{m};
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (queued.load(std::memory_order_seq_cst) == 0) {
+                if (stop) {
+                    sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    return;
+                }
+                cond.wait(lck, [this] { return stop || queued.load() > 0; });
+            }
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    static inline thread_local ThreadPool* current_pool = nullptr;
+    static inline thread_local std::size_t current_index = 0;
+
+    std::vector<std::unique_ptr<ChaseLevDeque<_TaskNode*>>> deques;
+    std::vector<std::thread> workers;
+    std::mutex m;
+    std::condition_variable cond;
+    std::deque<_TaskNode*> injected; // Tasks submitted from outside the pool.
+    std::atomic<std::size_t> injected_size{0}; // Read by find without m.
+    std::atomic<std::int64_t> queued{0};
+    std::atomic<int> sleepers{0}; // Workers in cond.wait or about to be.
+    bool stop = false;
+};